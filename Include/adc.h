@@ -9,12 +9,55 @@
 #define M                       (1620U)     // Typical slope:uV/oC
 #define STANDARD_TEMP           (25)
 
+#define TEMP_LUT_SEGMENTS       (64U)       // Interpolation segments of the conversion table
+#define TEMP_LUT_MIN_CENTI      (-4000)     // Table range in 0.01 oC, readings outside are clamped
+#define TEMP_LUT_MAX_CENTI      (12500)
+
+#if FLASH_RAM_STANDIN
+#define ADC_CAL_FLASH_ADDR      (FLASH_STANDIN_BASE)
+#else
+#define ADC_CAL_FLASH_ADDR      ((uint32_t)adcCalSector)    // Flash sector reserved in adc.c
+#endif
+#define ADC_CAL_MAGIC           (0x4C414341U)   // "ACAL"
+#define ADC_CAL_RECORD_VERSION  (1U)            // Bump when the record layout changes
+
+/* Calibration kept in flash so boot can skip the ADC self-calibration
+ * and the bandgap measurement. The record is ignored when the magic,
+ * version or CRC don't match, or when it was taken with a different
+ * converter configuration. */
+typedef struct adc_cal_record
+{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t plusSideGainValue;
+	uint16_t minusSideGainValue;     // 0xFFFF without ADC16_DIFF_MODE_ENABLE
+	uint16_t reserved;
+	uint32_t configId;               // my_crc32 of adcUserConfig
+	uint32_t adcrTemp25;
+	uint32_t adcr100m;
+	uint32_t crc;                    // my_crc32 of the fields above
+}adc_cal_record_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#if !FLASH_RAM_STANDIN
+extern const volatile uint8_t adcCalSector[FLASH_SECTOR_SIZE];
+#endif
+
 void app_ADCInit(void);
 void temp_CalibrateParam(void);
+bool temp_LoadCalibration(void);
+flash_status_t temp_SaveCalibration(void);
+int32_t temp_ConvertRaw(uint32_t adcValue);
+uint16_t temp_CentiToRaw(int32_t centi);
+adc16_Status_t temp_StartAlarm(int32_t lowCenti,
+							   int32_t highCenti,
+							   bool wakeInside,
+							   adc_hw_trigger_t trigger,
+							   uint32_t periodUs,
+							   adc_conv_callback_t callback);
 int32_t read_OnChipTemperature(void);
 
 #ifdef __cplusplus
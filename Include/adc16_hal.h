@@ -12,7 +12,7 @@
 #include "includes.h"
 #define ADC16_DIFF_MODE_ENABLE			(0)
 #define ADC16_HARDWARE_AVERAGE_ENABLE	(1)
-#define ADC16_DMA_ENABLE				(0)
+#define ADC16_DMA_ENABLE				(1)
 #define ADC_CALIBRATION_ENABLE			(1)
 
 /******************************************************************************
@@ -27,7 +27,8 @@ typedef enum _adc16_status
 {
 	status_ADC16_Success			=	0U,	
 	status_ADC16_InValidArgument	=	1U,
-	status_ADC16_Failed				=	2U
+	status_ADC16_Failed				=	2U,
+	status_ADC16_Busy				=	3U
 }adc16_Status_t;
 
 typedef enum _adc16_clk_divider
@@ -227,6 +228,29 @@ __STATIC_INLINE bool adc16_Hal_GetConvActiveFlag(void){
 	return (ADC_SC2_ADACT_MASK == (ADC0_SC2 & ADC_SC2_ADACT_MASK));	
 }
 
+__STATIC_INLINE void adc16_Hal_EnableHwTrigger(bool enable){
+	if(enable)
+		ADC0_SC2 |= ADC_SC2_ADTRG_MASK;
+	else
+		ADC0_SC2 &= ~ADC_SC2_ADTRG_MASK;
+}
+
+__STATIC_INLINE void adc16_Hal_EnableContinuous(bool enable){
+	if(enable)
+		ADC0_SC3 |= ADC_SC3_ADCO_MASK;
+	else
+		ADC0_SC3 &= ~ADC_SC3_ADCO_MASK;
+}
+
+#if ADC16_DMA_ENABLE
+__STATIC_INLINE void adc16_Hal_EnableDma(bool enable){
+	if(enable)
+		ADC0_SC2 |= ADC_SC2_DMAEN_MASK;
+	else
+		ADC0_SC2 &= ~ADC_SC2_DMAEN_MASK;
+}
+#endif /* ADC16_DMA_ENABLE */
+
 void adc16_Hal_ConfigHwCmp(const adc16_Hw_Cmp_Config_t *configPtr);
 
 #if ADC_CALIBRATION_ENABLE
@@ -35,6 +35,53 @@ typedef struct _pmc_bandgap_buffer_config
 #endif
 } pmc_bandgap_buffer_config_t;
 
+/* Called from ADC0_IRQHandler with the result of an ADC_StartConv */
+typedef void (*adc_conv_callback_t)(adc16_Ch_t ch, uint16_t value);
+
+/* Conversion trigger, values are the SIM_SOPT7 ADC0TRGSEL encodings.
+ * A PIT trigger runs the given PIT channel at the sample period; PIT_Init
+ * must have been called. Channel 0 is the task tick, so adcTriggerPit0 is
+ * refused with status_ADC16_InValidArgument. The channel is the ADC's
+ * until ADC_StopTriggered or ADC_StopMonitor, so nothing else may
+ * reprogram or stop it. A TPM trigger fires on the counter overflow
+ * of a TPM the caller has set up. */
+typedef enum adc_hw_trigger
+{
+	adcTriggerSoftware	=	0xFFU,	// Conversions start on the SC1A write
+	adcTriggerPit0		=	4U,
+	adcTriggerPit1		=	5U,
+	adcTriggerTpm0		=	8U,
+	adcTriggerTpm1		=	9U,
+	adcTriggerTpm2		=	10U
+}adc_hw_trigger_t;
+
+#if ADC16_DMA_ENABLE
+#define ADC_DMA_SOURCE			(40U)		// DMAMUX request source of ADC0
+#define ADC_SCAN_MAX_CH			(8U)
+
+typedef enum adc_scan_half
+{
+	adcScanHalf		=	0U,		// First half of the sample buffer is ready
+	adcScanFull		=	1U		// Second half of the sample buffer is ready
+}adc_scan_half_t;
+
+/* Called from the DMA ISR with a finished half of the sample buffer.
+ * block holds frames consecutive frames of chCount samples, one per
+ * scanned channel in list order: block[frame * chCount + chIndex]. */
+typedef void (*adc_scan_callback_t)(adc_scan_half_t half, const uint16_t *block, uint32_t frames);
+
+typedef struct adc_scan_config
+{
+	const adc16_Ch_t *chList;		// Channels converted in turn, one frame per pass
+	uint8_t chCount;				// Up to ADC_SCAN_MAX_CH
+	uint16_t *sampleBuf;			// 2 * framesPerHalf * chCount samples
+	uint32_t framesPerHalf;
+	adc_scan_callback_t callback;
+	adc_hw_trigger_t trigger;		// Software runs conversions back to back, a hardware trigger paces them
+	uint32_t periodUs;				// Trigger period for PIT triggers, one channel per trigger
+}adc_scan_config_t;
+#endif /* ADC16_DMA_ENABLE */
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
@@ -55,6 +102,37 @@ adc16_Status_t ADC_Disable(void);
 adc16_Status_t ADC_ConfigCh(adc16_Ch_Config_t *configPtr);
  
 void ADC_WaitForConvComplete(void);
+
+//Start a software-triggered conversion and return; the callback gets the result
+adc16_Status_t ADC_StartConv(adc16_Ch_t ch, adc_conv_callback_t callback);
+
+bool ADC_IsConvPending(void);
+
+//Convert ch on every hardware trigger; the callback gets each result
+adc16_Status_t ADC_StartTriggered(adc16_Ch_t ch,
+								  adc_hw_trigger_t trigger,
+								  uint32_t periodUs,
+								  adc_conv_callback_t callback);
+
+void ADC_StopTriggered(void);
+
+//Convert ch continuously (software trigger) or on every hardware trigger
+//with the compare function on; only results that pass the compare
+//complete, so the callback runs only then
+adc16_Status_t ADC_StartMonitor(adc16_Ch_t ch,
+								const adc16_Hw_Cmp_Config_t *cmpConfigPtr,
+								adc_hw_trigger_t trigger,
+								uint32_t periodUs,
+								adc_conv_callback_t callback);
+
+void ADC_StopMonitor(void);
+
+#if ADC16_DMA_ENABLE
+//Convert the channel list over and over, the DMA storing every result
+adc16_Status_t ADC_ScanStart(const adc_scan_config_t *configPtr);
+
+void ADC_ScanStop(void);
+#endif
  
 void ADC_PauseConv(void);
 
@@ -11,15 +11,27 @@
 
 #include "includes.h"
 
+#define CB_MAX_ITEMS	(0x80000000U)	// Largest power of two a uint32_t size holds
+
 /********************************************************
  * Circular buffer structure declaration
+ *
+ * The size is always a power of two. head and tail are
+ * free-running indices: the number of items in the buffer
+ * is (tail - head) and a slot is found by masking the
+ * index with (size - 1), so no pointer compare is needed
+ * to wrap around.
+ *
+ * Only the consumer writes head and only the producer
+ * writes tail, so one ISR and the main loop can share a
+ * buffer without disabling interrupts.
  */
 typedef struct CircBuf{
-	uint8_t * buffer;	//pointer to the buffer in memory
-	uint8_t * head;		//pointer to the oldest data
-	uint8_t * tail;		//pointer to the newest data
-	size_t	size;		//size of the buffer
-	size_t  length;		//current number of items in the buffer
+	uint8_t * buffer;			//pointer to the buffer in memory
+	volatile uint32_t head;		//index of the oldest data
+	volatile uint32_t tail;		//index of the next free slot
+	uint32_t  size;		//size of the buffer, power of two
+	uint32_t  mask;		//size - 1, wraps an index into the buffer
 }CircBuf_t;
 
 /********************************************************
@@ -85,14 +97,109 @@ CB_e cb_Enqueue(CircBuf_t * cb, uint8_t data);
  */
 CB_e cb_Dequeue(CircBuf_t * cb, uint8_t *output);
 
+/********************************************************
+ *@name        cb_Length
+ *
+ *@description Get the number of items in the circular buffer 
+ *
+ *@param       cb - pointer to the circular buffer
+ * 
+ *@return      number of items currently stored
+ */
+uint32_t cb_Length(CircBuf_t * cb);
+
+/********************************************************
+ *@name        cb_EnqueueBulk
+ *
+ *@description Enqueue a block of data into the circular buffer
+ *             with at most two block copies 
+ *
+ *@param       cb - pointer to the circular buffer
+ *             data - pointer to the data to enqueue
+ *             num - number of bytes to enqueue
+ * 
+ *@return      number of bytes enqueued, less than num if the
+ *             buffer runs out of space
+ */
+uint32_t cb_EnqueueBulk(CircBuf_t * cb, const uint8_t * data, uint32_t num);
+
+/********************************************************
+ *@name        cb_DequeueBulk
+ *
+ *@description Dequeue a block of data from the circular buffer
+ *             with at most two block copies 
+ *
+ *@param       cb - pointer to the circular buffer
+ *             output - pointer to the location that will store the dequeued data
+ *             num - maximum number of bytes to dequeue
+ * 
+ *@return      number of bytes dequeued, less than num if the
+ *             buffer runs out of data
+ */
+uint32_t cb_DequeueBulk(CircBuf_t * cb, uint8_t * output, uint32_t num);
+
+/********************************************************
+ *@name        cb_PeekContiguous
+ *
+ *@description Get the largest linear region of data that can be read
+ *             straight from the buffer memory, without dequeuing it 
+ *
+ *@param       cb - pointer to the circular buffer
+ *             ptr - location that will store a pointer to the oldest data
+ *             len - location that will store the length of the region
+ * 
+ *@return      EMPTY(0): buffer is empty, *len is 0
+ *             NORMAL(2): ptr and len describe the readable region
+ */
+CB_e cb_PeekContiguous(CircBuf_t * cb, uint8_t ** ptr, uint32_t * len);
+
+/********************************************************
+ *@name        cb_Commit
+ *
+ *@description Release data read in place after cb_PeekContiguous 
+ *
+ *@param       cb - pointer to the circular buffer
+ *             num - number of bytes consumed, at most the peeked length
+ */
+void cb_Commit(CircBuf_t * cb, uint32_t num);
+
+/********************************************************
+ *@name        cb_Reserve
+ *
+ *@description Get the largest linear region of free space that can be
+ *             written straight into the buffer memory 
+ *
+ *@param       cb - pointer to the circular buffer
+ *             ptr - location that will store a pointer to the free space
+ *             len - location that will store the length of the region
+ * 
+ *@return      FULL(1): buffer is full, *len is 0
+ *             NORMAL(2): ptr and len describe the writable region
+ */
+CB_e cb_Reserve(CircBuf_t * cb, uint8_t ** ptr, uint32_t * len);
+
+/********************************************************
+ *@name        cb_Publish
+ *
+ *@description Make data written in place after cb_Reserve visible
+ *             to the consumer 
+ *
+ *@param       cb - pointer to the circular buffer
+ *             num - number of bytes written, at most the reserved length
+ */
+void cb_Publish(CircBuf_t * cb, uint32_t num);
+
 /********************************************************
  *@name        cb_Init
  *
  *@description Initialize a circular buffer 
  *
  *@param       cb - pointer to the circular buffer
- *             number_items - size of the buffer
+ *             number_items - size of the buffer, rounded up
+ *                            to the next power of two
  *@return      pointer to a CircBuf_t structure
+ *             NULL: num_items is 0 or above CB_MAX_ITEMS, or
+ *                   buffer memory could not be allocated
  *
  */
 CircBuf_t * cb_Init(CircBuf_t * cb, uint32_t num_items);
@@ -12,6 +12,9 @@
 
 #include <stdint.h>
 
+#define DATA_FTOA_DECIMALS		(3U)		// Decimal places printed by my_ftoa
+#define DATA_FTOA_MAX_DECIMALS	(9U)
+
 /****************************************************
 * @name: my_itoa
 *
@@ -28,15 +31,41 @@ uint8_t * my_itoa(uint8_t *str, int32_t data, int32_t base);
 /****************************************************
 * @name: my_ftoa
 *
-* @description: Converts a float value to an ASCII string
+* @description: Converts a float value to an ASCII string with
+*               DATA_FTOA_DECIMALS decimal places. The IEEE-754
+*               bits are split into fixed-point integer and fraction
+*               parts, so no soft-float arithmetic is used.
+*               |fdata| must be below 2^32, larger values print "ovf".
 *
 * @param: str -- pointer to the string
 * 				fdata -- the float value to be converted
 *
-* @return: the integer converted from the string
+* @return: pointer to the string
 */
 uint8_t * my_ftoa(uint8_t *str, float fdata);
 
+/****************************************************
+* @name: my_ftoa_n
+*
+* @description: my_ftoa with a given number of decimal places,
+*               up to DATA_FTOA_MAX_DECIMALS
+*/
+uint8_t * my_ftoa_n(uint8_t *str, float fdata, uint8_t decimals);
+
+/****************************************************
+* @name: my_q16toa
+*
+* @description: Converts a Q16.16 fixed-point value to an ASCII
+*               string without touching float
+*
+* @param: str -- pointer to the string
+* 				q16 -- the value scaled by 65536
+* 				decimals -- decimal places, up to DATA_FTOA_MAX_DECIMALS
+*
+* @return: pointer to the string
+*/
+uint8_t * my_q16toa(uint8_t *str, int32_t q16, uint8_t decimals);
+
 /****************************************************
 * @name: my_atoi
 *
@@ -48,4 +77,17 @@ uint8_t * my_ftoa(uint8_t *str, float fdata);
 */
 int32_t  my_atoi(uint8_t *str);
 
+/****************************************************
+* @name: my_crc32
+*
+* @description: CRC-32 (IEEE 802.3, reflected 0xEDB88320) of a
+*               byte buffer, using a 16-entry nibble table
+*
+* @param: data -- pointer to the bytes
+*         length -- number of bytes
+*
+* @return: the CRC, 0xCBF43926 for "123456789"
+*/
+uint32_t my_crc32(const uint8_t *data, uint32_t length);
+
 #endif /* __DATA_H__ */
@@ -0,0 +1,86 @@
+/***************************************************************************
+ *
+ *	Filename: 		decimator.h
+ *  Description:  	ADC oversampling and decimation filter header file
+ *
+ *****************************************************************************/
+#ifndef __DECIMATOR_H__
+#define __DECIMATOR_H__
+
+#include "includes.h"
+
+#define DEC_MAX_STAGES			(3U)	// Highest CIC order
+#define DEC_MAX_BITS			(32U)	// Register width, bounds the CIC bit growth
+
+/********************************************************
+ * Decimator state
+ *
+ * An order-N CIC (cascaded integrator-comb) filter that
+ * keeps one output per ratio input samples. Order 1 is
+ * a plain boxcar average. The sum of ratio samples grows
+ * by N * log2(ratio) bits; the output is shifted so it
+ * carries outBits bits. Oversampling a noisy signal by
+ * 4^k adds about k effective bits.
+ *
+ * The integrators wrap modulo 2^32, which the comb
+ * stages undo as long as the output fits the register.
+ */
+typedef struct decimator
+{
+	uint32_t integ[DEC_MAX_STAGES];		// Integrator stages
+	uint32_t comb[DEC_MAX_STAGES];		// Previous input of each comb stage
+	uint32_t ratio;						// Decimation ratio, power of two
+	uint32_t phase;						// Input samples since the last output
+	uint8_t  stages;					// CIC order, 1 for a boxcar
+	uint8_t  outShift;					// Right shift from the CIC gain to outBits
+}decimator_t;
+
+typedef enum dec_status
+{
+	status_DEC_Success			=	0U,
+	status_DEC_InvalidArgument	=	1U
+}dec_status_t;
+
+/****************************************************
+* @name: dec_Init
+*
+* @description: set up a decimator and clear its state
+*
+* @param: dec -- decimator state
+*         ratio -- decimation ratio, a power of two
+*         stages -- CIC order, 1..DEC_MAX_STAGES
+*         inBits -- bits per input sample
+*         outBits -- bits per output sample, at most
+*                    inBits + stages * log2(ratio)
+*
+* @return: status_DEC_Success, or status_DEC_InvalidArgument
+*          if the filter would not fit DEC_MAX_BITS
+*/
+dec_status_t dec_Init(decimator_t *dec, uint32_t ratio, uint8_t stages, uint8_t inBits, uint8_t outBits);
+
+/****************************************************
+* @name: dec_Reset
+*
+* @description: clear the filter state, keeping the settings
+*/
+void dec_Reset(decimator_t *dec);
+
+/****************************************************
+* @name: dec_Process
+*
+* @description: run a block of samples through the decimator.
+*               A block may end in the middle of an output, the
+*               state carries over to the next call.
+*
+* @param: dec -- decimator state
+*         in -- input samples, e.g. a DMA-filled ADC block
+*         stride -- distance between samples of this signal,
+*                   the channel count of an interleaved scan block
+*         count -- number of samples of this signal in the block
+*         out -- output buffer, room for count / ratio + 1 results
+*
+* @return: number of outputs written
+*/
+uint32_t dec_Process(decimator_t *dec, const uint16_t *in, uint32_t stride, uint32_t count, uint32_t *out);
+
+#endif /* __DECIMATOR_H__ */
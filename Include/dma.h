@@ -13,6 +13,54 @@
 #include "includes.h"
 
 #define DMA_ISR_ENABLE		(1)
+#define DMA_CHANNEL_CNT		(4U)
+#define DMA_CHANNEL_NONE	(0xFFU)		// Returned by dma_ChannelAlloc when all channels are taken
+
+typedef enum dma_status
+{
+	status_DMA_Success			=	0U,
+	status_DMA_InvalidArgument	=	1U,
+	status_DMA_Busy				=	2U,		// No free channel
+	status_DMA_Error			=	3U,		// Configuration or bus error
+	status_DMA_Timeout			=	4U
+}dma_status_t;
+
+typedef enum dma_job_state
+{
+	dmaJobIdle	=	0U,
+	dmaJobBusy,
+	dmaJobDone,
+	dmaJobError
+}dma_job_state_t;
+
+/* Called from the DMA ISR once a channel has finished its transfer */
+typedef void (*dma_callback_t)(uint8_t dma_ch);
+
+struct dma_job;
+
+/* Called from the DMA ISR when a job completes or fails */
+typedef void (*dma_job_callback_t)(struct dma_job *job);
+
+/* One segment of a scatter/gather list */
+typedef struct dma_sg_desc
+{
+	uint8_t *dst;
+	const uint8_t *src;
+	uint32_t length;
+}dma_sg_desc_t;
+
+/* One asynchronous memory transfer. The job must stay valid until it is
+ * no longer busy; its channel is returned to the pool on completion. */
+typedef struct dma_job
+{
+	volatile dma_job_state_t state;
+	uint8_t dma_ch;
+	dma_job_callback_t callback;
+	void *usrData;
+	const dma_sg_desc_t *segList;		// NULL for a single block job
+	uint32_t segCount;
+	volatile uint32_t segIndex;			// Segment being transferred
+}dma_job_t;
 
 uint8_t dma_Init_Mem2mem(uint8_t dma_ch, 
 						 uint8_t * source_addr,
@@ -30,6 +78,43 @@ uint8_t dma_Init_Per2Mem(uint8_t dma_ch,
 						 uint8_t * source_addr,
 						 uint8_t * destination_addr,
 						 uint32_t transfer_size);
+
+void dma_SetCallback(uint8_t dma_ch, dma_callback_t callback);
+
+/* Take a free channel out of the pool, or DMA_CHANNEL_NONE */
+uint8_t dma_ChannelAlloc(void);
+
+void dma_ChannelFree(uint8_t dma_ch);
+
+/* Start copying length bytes from src to dst; word transfers are used
+ * when both addresses and the length are word aligned */
+dma_status_t dma_MemcpyAsync(dma_job_t *job,
+							 uint8_t * dst,
+							 const uint8_t * src,
+							 uint32_t length,
+							 dma_job_callback_t callback,
+							 void *usrData);
+
+/* Start filling length bytes at dst with value, read from a static
+ * per-channel pattern word so the source outlives the caller */
+dma_status_t dma_MemsetAsync(dma_job_t *job,
+							 uint8_t * dst,
+							 uint8_t value,
+							 uint32_t length,
+							 dma_job_callback_t callback,
+							 void *usrData);
+
+/* Run the segments of list one after the other on a single channel; the
+ * DMA ISR launches each next segment, so the list must stay valid until
+ * the job is no longer busy */
+dma_status_t dma_ScatterGatherAsync(dma_job_t *job,
+									const dma_sg_desc_t *list,
+									uint32_t count,
+									dma_job_callback_t callback,
+									void *usrData);
+
+/* Wait up to timeout ms (or SYS_WAIT_FOREVER) for a job to finish */
+dma_status_t dma_Wait(dma_job_t *job, uint32_t timeout);
 						 
 #endif
 
@@ -0,0 +1,82 @@
+/***************************************************************************
+ *
+ *	Filename: 		flash.h
+ *  Description:  	program flash (FTFA) driver header file
+ *
+ *****************************************************************************/
+#ifndef __FLASH_H__
+#define __FLASH_H__
+
+#include "includes.h"
+
+/* Build with FLASH_RAM_STANDIN=1 to keep the "flash" in a RAM array with
+ * the same erase/program rules, e.g. for host tests of the record code */
+#ifndef FLASH_RAM_STANDIN
+#define FLASH_RAM_STANDIN		(0)
+#endif
+
+#define FLASH_SECTOR_SIZE		(1024U)			// Erase unit of the KL25Z program flash
+#define FLASH_ERASED_WORD		(0xFFFFFFFFU)
+
+#if FLASH_RAM_STANDIN
+#define FLASH_STANDIN_BASE		(0x0001FC00U)	// Address range the stand-in answers to
+#define FLASH_STANDIN_SECTORS	(1U)
+#endif
+
+typedef enum flash_status
+{
+	status_FLASH_Success			=	0U,
+	status_FLASH_InvalidArgument	=	1U,		// Unaligned or out of range
+	status_FLASH_AccessError		=	2U,		// ACCERR or FPVIOL, e.g. protected sector
+	status_FLASH_VerifyError		=	3U		// MGSTAT0, the operation did not complete
+}flash_status_t;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/****************************************************
+* @name: flash_EraseSector
+*
+* @description: erase the FLASH_SECTOR_SIZE sector at addr to all ones.
+*               Interrupts are masked while the command runs, since
+*               the flash can't be read meanwhile.
+*
+* @param: addr -- sector aligned flash address
+*
+* @return: flash_status_t
+*/
+flash_status_t flash_EraseSector(uint32_t addr);
+
+/****************************************************
+* @name: flash_Program
+*
+* @description: program words into erased flash, one longword
+*               command each
+*
+* @param: addr -- word aligned flash address
+*         data -- words to write
+*         words -- number of words
+*
+* @return: flash_status_t
+*/
+flash_status_t flash_Program(uint32_t addr, const uint32_t *data, uint32_t words);
+
+/****************************************************
+* @name: flash_Read
+*
+* @description: copy bytes out of flash
+*
+* @param: addr -- flash address
+*         data -- destination
+*         length -- number of bytes
+*
+* @return: flash_status_t
+*/
+flash_status_t flash_Read(uint32_t addr, void *data, uint32_t length);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __FLASH_H__ */
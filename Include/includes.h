@@ -18,6 +18,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <assert.h>
 
 /*********************************************************************************************************
@@ -42,6 +43,7 @@
 #include "tsi_hal.h"
 #include "pit_hal.h"
 #include "pit.h"
+#include "flash.h"
 #include "adc16_hal.h"
 #include "adc_driver.h"
 #include "adc.h"
@@ -53,6 +55,12 @@
 /*********************************************************************************************************
   User's header files 
 *********************************************************************************************************/
+#include "memory.h"
+#include "dma.h"
+#include "circbuf.h"
+#include "data.h"
+#include "log.h"
+#include "decimator.h"
 
 /*********************************************************************************************************
   Macro 
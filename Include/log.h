@@ -16,10 +16,103 @@ extern "C" {
 
 #include "includes.h"
 
+/* Deferred records, must be a power of two. The log_Int call sites make
+ * text frames of about 22 bytes, so the 256-byte UART0 TX buffer holds
+ * about 12; a deeper ring only holds records that would wait for the UART
+ * anyway. 16 covers the burst logged before the main loop first runs
+ * log_Process (up to 6: ADC calibration and the TSI baselines) with room
+ * for ISR logging, at 12 bytes per record. Tests/test_log_bench.c measures
+ * the frame sizes and the per-call cost. */
+#define LOG_RECORD_CNT			(16U)
+#define LOG_Q16_DECIMALS		(3U)	// Decimal places printed by log_Q16
+
+/****************************************************
+* Compile-time log filtering
+*
+* LOG_ERR/LOG_WRN/LOG_INF/LOG_DBG(module, kind, args...) call
+* log_<kind>(args...) only if the module's level allows it,
+* e.g. LOG_DBG(MOD_TSI, Int, (uint8_t *)"baseline ", counter).
+* A filtered call site expands to nothing, so its arguments
+* are never evaluated and the formatter is not linked in.
+*
+* Modules: MOD_ADC, MOD_TSI, MOD_UART, MOD_DMA, MOD_SYS, MOD_TASK.
+* Override a module's level before including this header, e.g.
+* -DLOG_LEVEL_MOD_TSI=4. Levels must be plain digits.
+*/
+#define LOG_LEVEL_NONE			0
+#define LOG_LEVEL_ERR			1
+#define LOG_LEVEL_WRN			2
+#define LOG_LEVEL_INF			3
+#define LOG_LEVEL_DBG			4
+
+#ifndef LOG_LEVEL_DEFAULT
+#ifdef DEBUG
+#define LOG_LEVEL_DEFAULT		LOG_LEVEL_INF
+#else
+#define LOG_LEVEL_DEFAULT		LOG_LEVEL_NONE
+#endif
+#endif
+
+#ifndef LOG_LEVEL_MOD_ADC
+#define LOG_LEVEL_MOD_ADC		LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_MOD_TSI
+#define LOG_LEVEL_MOD_TSI		LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_MOD_UART
+#define LOG_LEVEL_MOD_UART		LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_MOD_DMA
+#define LOG_LEVEL_MOD_DMA		LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_MOD_SYS
+#define LOG_LEVEL_MOD_SYS		LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_LEVEL_MOD_TASK
+#define LOG_LEVEL_MOD_TASK		LOG_LEVEL_DEFAULT
+#endif
+
+#define LOG_ERR(mod, ...)		LOG_EMIT(mod, LOG_LEVEL_ERR, __VA_ARGS__)
+#define LOG_WRN(mod, ...)		LOG_EMIT(mod, LOG_LEVEL_WRN, __VA_ARGS__)
+#define LOG_INF(mod, ...)		LOG_EMIT(mod, LOG_LEVEL_INF, __VA_ARGS__)
+#define LOG_DBG(mod, ...)		LOG_EMIT(mod, LOG_LEVEL_DBG, __VA_ARGS__)
+
+/* LOG_ON_<module level>_<call level> is 1 if the call is kept */
+#define LOG_ON_0_1	0
+#define LOG_ON_0_2	0
+#define LOG_ON_0_3	0
+#define LOG_ON_0_4	0
+#define LOG_ON_1_1	1
+#define LOG_ON_1_2	0
+#define LOG_ON_1_3	0
+#define LOG_ON_1_4	0
+#define LOG_ON_2_1	1
+#define LOG_ON_2_2	1
+#define LOG_ON_2_3	0
+#define LOG_ON_2_4	0
+#define LOG_ON_3_1	1
+#define LOG_ON_3_2	1
+#define LOG_ON_3_3	1
+#define LOG_ON_3_4	0
+#define LOG_ON_4_1	1
+#define LOG_ON_4_2	1
+#define LOG_ON_4_3	1
+#define LOG_ON_4_4	1
+
+#define LOG_CAT_(a, b)			a##b
+#define LOG_CAT(a, b)			LOG_CAT_(a, b)
+#define LOG_ON(cfg, lvl)		LOG_CAT(LOG_CAT(LOG_ON_, cfg), LOG_CAT(_, lvl))
+#define LOG_EMIT(mod, lvl, ...)	LOG_CAT(LOG_EMIT_, LOG_ON(LOG_CAT(LOG_LEVEL_, mod), lvl))(__VA_ARGS__)
+#define LOG_EMIT_0(...)			do {} while(0)
+#define LOG_EMIT_1(kind, ...)	log_##kind(__VA_ARGS__)
+
 /****************************************************
 * @name: log_Str
 *
-* @description: Log a string
+* @description: Log a string. log_Str/log_Int/log_Float only
+*               record the string pointer and the argument;
+*               the text is built later by log_Process, so the
+*               string must not be a stack buffer.
 *               
 * @param: src -- pointer to the string to be logged
 *
@@ -29,7 +122,9 @@ extern void log_Str(uint8_t *str);
 /****************************************************
 * @name: log_Mem
 *
-* @description: Log a memory segment
+* @description: Log a memory segment. It is not deferred: the
+*               bytes go into the TX buffer as LOG_EVT_MEM frames
+*               right away, and a frame without room is dropped.
 *               
 * @param: src -- pointer to the memory location
 * 		  num -- number of bytes memory to be logged
@@ -59,6 +154,78 @@ extern void log_Int(uint8_t * str, int32_t data);
 */
 extern void log_Float(uint8_t * str, float fdata);
 
+/****************************************************
+* @name: log_Q16
+*
+* @description: Log a string with a Q16.16 fixed-point value,
+*               printed with LOG_Q16_DECIMALS places and no
+*               float arithmetic
+*               
+* @param: str -- pointer to the string to be logged
+* 		  q16 -- value scaled by 65536
+*
+*/
+extern void log_Q16(uint8_t * str, int32_t q16);
+
+/****************************************************
+* @name: log_Process
+*
+* @description: Format the pending log_Str/log_Int/log_Float/log_Q16
+*               records into the TX buffer as LOG_EVT_TEXT frames.
+*               Call from the idle loop, when no event is pending.
+*
+* @return: true if records are still pending
+*
+*/
+extern bool log_Process(void);
+
+/****************************************************
+* Binary event record
+*
+* byte 0      : bits 7..6 number of arguments (0-3)
+*               bits 5..0 event ID
+* varint      : milliseconds since the previous record (LPTMR)
+* varint x n  : arguments, zigzag encoded so small negative
+*               values stay short
+*
+* Varints are 7 bits per byte, least significant group first,
+* bit 7 set on every byte but the last. Tools/log_decode.py
+* turns a captured stream back into timestamped lines.
+*
+* Everything on the wire is a record, so the decoder never has to
+* guess where one ends. The text of log_Str/log_Int/log_Float/log_Q16
+* and the bytes of log_Mem go out as frames with no arguments:
+*
+* byte 0      : LOG_EVT_TEXT or LOG_EVT_MEM
+* varint      : milliseconds since the previous record, taken when
+*               log_Process (or log_Mem) writes the frame
+* varint      : payload length, at most LOG_FRAME_MAX_LEN
+* n bytes     : ASCII text, or the raw memory bytes
+*/
+#define LOG_EVT_ID_MASK			(0x3FU)
+#define LOG_EVT_ARGC_SHIFT		(6U)
+#define LOG_EVT_MAX_ARGS		(3U)
+#define LOG_EVT_MEM				(0x3EU)	// Reserved, log_Mem frame
+#define LOG_EVT_TEXT			(0x3FU)	// Reserved, formatted text frame
+#define LOG_FRAME_MAX_LEN		(127U)	// Longer payloads are cut, the length stays one byte
+
+/****************************************************
+* @name: log_Event / log_Event1 / log_EventArgs
+*
+* @description: Log a binary, timestamped event record. The
+*               record is dropped as a whole if the TX buffer
+*               has no room for it. Call from the main loop only.
+*               
+* @param: evtId -- event ID, below LOG_EVT_MEM
+* 		  arg -- argument of the event
+* 		  args -- pointer to the arguments of the event
+* 		  argc -- number of arguments, at most LOG_EVT_MAX_ARGS
+*
+*/
+extern void log_Event(uint8_t evtId);
+extern void log_Event1(uint8_t evtId, int32_t arg);
+extern void log_EventArgs(uint8_t evtId, const int32_t * args, uint8_t argc);
+
 
 #ifdef __cplusplus
 }
@@ -15,6 +15,11 @@
 #define SUCCESS 0;
 #define ERROR   1;
 
+#define MEM_WORD_COPY_MIN	(16U)	// Shorter copies are not worth aligning
+#define MEM_DMA_THRESHOLD_DEFAULT	(256U)	// mem_Copy hands copies this long to the DMA
+#define MEM_CALIBRATION_MAX_LENGTH	(1024U)
+#define MEM_CALIBRATION_RUNS	(5U)	// Timed runs per size and path, the fastest counts
+
 /****************************************************
 * @name: my_memmove
 *
@@ -27,6 +32,19 @@
 * @return:SUCCESS/ERROR 
 */
 int8_t my_memmove(uint8_t *src, uint8_t *dst, int32_t length);
+
+/****************************************************
+* @name: my_memmove_word
+*
+* @description: copy data from one memory to the other in aligned
+*               words; src and dst may have any alignment and may overlap
+*               
+* @param: src -- pointer to the source address
+*         dst -- pointer to the destination address
+*         length -- lenth of memory bytes to copy
+*
+* @return:SUCCESS/ERROR 
+*/
 int8_t my_memmove_word(uint8_t * src, uint8_t * dst, int32_t length);
 
 /***************************************************************************
@@ -45,10 +63,60 @@ int8_t my_memmove_word(uint8_t * src, uint8_t * dst, int32_t length);
 int8_t dma_memmove(uint8_t * src, uint8_t * dst, uint32_t length, uint8_t ch);
 int8_t dma_memmove_word(uint8_t * src, uint8_t * dst, uint32_t length, uint8_t ch);
 
+/****************************************************
+* @name: mem_Copy
+*
+* @description: copy data from one memory to the other with the CPU or
+*               the DMA, whichever is faster for the size and alignment 
+*               
+* @param: dst -- pointer to the destination address
+*         src -- pointer to the source address
+*         length -- lenth of memory bytes to copy
+*
+* @return:SUCCESS/ERROR 
+*/
+int8_t mem_Copy(uint8_t * dst, uint8_t * src, uint32_t length);
+
+/****************************************************
+* @name: mem_SetDmaThreshold / mem_GetDmaThreshold
+*
+* @description: set or get the copy size from which mem_Copy uses the DMA
+*/
+void mem_SetDmaThreshold(uint32_t length);
+uint32_t mem_GetDmaThreshold(void);
+
+/****************************************************
+* @name: mem_CalibrateDmaThreshold
+*
+* @description: measure the CPU and DMA copy paths with SysTick and set
+*               the DMA threshold where the DMA becomes faster. Both PIT
+*               channels are taken (0: task tick, 1: temperature alarm),
+*               so the timing runs on SysTick, which has no other user;
+*               its setting is restored afterwards. ST_TaskInit calls it
+*               once, before the task tick starts.
+*
+* @return: the new threshold
+*/
+uint32_t mem_CalibrateDmaThreshold(void);
+
+/****************************************************
+* @name: mem_Fill
+*
+* @description: fill memory with a repeating 32-bit pattern, byte i
+*               getting byte (i % 4) of the pattern (little-endian).
+*               Uses aligned, unrolled word stores for the body.
+*               
+* @param: dst -- pointer to the memory address
+*         pattern -- 32-bit pattern to repeat
+*         length -- lenth of memory bytes to fill
+*
+* @return:SUCCESS/ERROR 
+*/
+int8_t mem_Fill(uint8_t * dst, uint32_t pattern, uint32_t length);
 /****************************************************
 * @name: my_memzero
 *
-* @description: zero out memory 
+* @description: zero out memory, a mem_Fill with a zero pattern
 *               
 * @param: src -- pointer to the memory address
 *         length -- lenth of memory bytes to zero out
@@ -75,7 +143,8 @@ int8_t dma_memzero_word(uint8_t * src, uint32_t length, uint8_t ch);
 * @name: my_reverse
 *
 * @description: reverse the order of certain bytes 
-*               starting from a memory location 
+*               starting from a memory location, swapping
+*               REV-reversed words from both ends
 *               
 * @param: src -- pointer to the starting memory address
 *         length -- lenth of memory bytes to reverse
@@ -83,5 +152,18 @@ int8_t dma_memzero_word(uint8_t * src, uint32_t length, uint8_t ch);
 * @return:SUCCESS/ERROR 
 */
 int8_t my_reverse(uint8_t *src, uint32_t length);
+/****************************************************
+* @name: mem_Bswap16_Array / mem_Bswap32_Array
+*
+* @description: convert an array of 16/32-bit elements between
+*               little and big endian in place
+*               
+* @param: data -- pointer to the array
+*         count -- number of elements
+*
+* @return:SUCCESS/ERROR 
+*/
+int8_t mem_Bswap16_Array(uint16_t *data, uint32_t count);
+int8_t mem_Bswap32_Array(uint32_t *data, uint32_t count);
 
 #endif /* __MEMORY_H__ */
@@ -28,13 +28,15 @@ typedef struct mutex
     uint32_t         timeout;    /*!< Timeout to wait in milliseconds                 */
 } mutex_t;
 
+/* Single-producer/single-consumer queue: the writer (ISR) only moves the tail
+ * and the reader (main loop) only moves the head, so neither side has to mask
+ * interrupts. One slot is kept free to tell a full queue from an empty one. */
 typedef struct MsgQueue
 {
     uint8_t              *queueMem;      /*!< Points to the queue memory               */
-    uint8_t               size;          /*!< The size of the queue        */
-    uint8_t               head;          /*!< Index of the next message to be read     */
-    uint8_t               tail;          /*!< Index of the next place to write to      */
-    volatile bool          isEmpty;       /*!< Whether queue is empty                   */
+    uint8_t               size;          /*!< Number of slots, one more than capacity  */
+    volatile uint8_t      head;          /*!< Index of the next message to be read     */
+    volatile uint8_t      tail;          /*!< Index of the next place to write to      */
 }msg_queue_t;
 
 typedef msg_queue_t*	msg_queue_handler_t;
@@ -72,10 +74,21 @@ system_status_t SYS_SemaDestroy(semaphore_t *pSem);
 
 msg_queue_handler_t SYS_MsgQueueCreate(msg_queue_t *queue, uint8_t queue_size);
 
+/* There is a single producer slot: the load of tail, the write and the
+ * store of tail must not be interleaved with another SYS_MsgEnqueue. Every
+ * ISR that enqueues must therefore run at the same NVIC priority (handlers
+ * of equal priority never preempt each other), and thread code may only
+ * enqueue with interrupts masked. ST_TaskInit sets ST_MSG_IRQ_PRIORITY on
+ * PORTD, ADC0 and TSI0 for this. */
 system_status_t SYS_MsgEnqueue(msg_queue_handler_t handler, void* pMsg);
 
 system_status_t SYS_MsgDequeue(msg_queue_handler_t handler, void* pMsg);
 
+__STATIC_INLINE bool SYS_MsgQueueIsEmpty(msg_queue_handler_t handler)
+{
+	return (handler->head == handler->tail);
+}
+
 uint32_t SYS_TimeDiff(uint32_t time_start, uint32_t time_end);
 
 uint32_t SYS_TimeGetMsec(void);
@@ -92,6 +105,26 @@ __STATIC_INLINE void SYS_EnableIRQGlobal(void)
 	__enable_irq();
 }
 
+/* Critical section that can nest: returns the previous PRIMASK so that
+ * SYS_RestoreIRQ only re-enables interrupts if they were enabled before */
+__STATIC_INLINE uint32_t SYS_SaveDisableIRQ(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	return primask;
+}
+
+__STATIC_INLINE void SYS_RestoreIRQ(uint32_t primask)
+{
+	__set_PRIMASK(primask);
+}
+
+/* Orders buffer accesses against the index update that publishes them */
+__STATIC_INLINE void SYS_MemoryBarrier(void)
+{
+	__DMB();
+}
+
 #if defined(__cplusplus)
 }
 #endif
@@ -4,13 +4,21 @@
 #include "includes.h"
 
 #define ST_MSG_QUEUE_SIZE				(16U)
+#define ST_MSG_IRQ_PRIORITY				(2U)		// Shared by every ISR that enqueues, see SYS_MsgEnqueue
 
 #define ST_KEY_PRESSED_MSG				(1U)
+#define ST_TEMP_READY_MSG				(2U)
+#define ST_TOUCH_READY_MSG				(3U)
 
 #define ST_PERIODIC_EVT_UNITPERIOD		(1000U)
-#define ST_SENSE_TOUCH_EVT				(0x00000001U)
+
+#define ST_TEMP_LOW_CENTI				(2000)		// Normal temperature window in 0.01 oC
+#define ST_TEMP_HIGH_CENTI				(2799)
+#define ST_TEMP_HW_ALARM				(1)			// Supervise the window with the ADC compare function
+#define ST_TEMP_ALARM_PERIOD_US			(100000U)	// PIT1-triggered sample period of the alarm
 #define ST_READ_TEMP_EVT				(0x00000002U)
 #define ST_BLINK_LED_EVT				(0x00000004U)
+#define ST_TSI_BASELINE_TRIES			(3U)		// TSI_BaselineInit attempts before touch sensing is left off
 
 #define SYSTEM_INITIALIZED	(0x0)
 #define SYSTEM_ENTERED_WAIT (0x1)
@@ -19,7 +27,9 @@
 #define READING_SYS_TEMPERATURE	(0x10)
 #define SYSTEM_TEMPERATURE_NORMAL (0x11)
 #define SYSTEM_TEMPERATURE_OUTOFRANGE (0x12)
+#define TEMP_CALIBRATION_NOT_SAVED	(0x13)	// Argument: the flash_status_t of the save
 #define SYSTEM_SENSED_TOUCH	(0x20)
+#define TSI_BASELINE_FAILED	(0x21)	// Argument: the tsi_status_t of the last TSI_BaselineInit
 #if defined(__cplusplus)
 extern "C" {
 #endif
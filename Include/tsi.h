@@ -44,6 +44,32 @@ typedef struct tsi_state
 	uint16_t counters[MAX_TSI_CHANNEL_INDEX];
 }tsi_state_t;
 
+/* Baseline tracking. The untouched counter follows a slow IIR filter
+ * that only runs while the electrode is released: readings below the
+ * baseline pull it down at the fast recovery rate, readings above it
+ * by less than the release delta raise it at the slow drift rate. The
+ * touch threshold is a multiple of the noise standard deviation,
+ * measured from the readings within the release delta, with
+ * TSI_BASELINE_MIN_DELTA as a floor. */
+#define TSI_BASELINE_FRAC_BITS		(8U)		// Baseline and variance are kept in Q8
+#define TSI_BASELINE_DRIFT_SHIFT	(9U)		// Slow drift, 1/512 of the error per scan
+#define TSI_BASELINE_RECOVER_SHIFT	(3U)		// Fast recovery, 1/8 of the error per scan
+#define TSI_NOISE_SHIFT				(6U)		// Variance filter, 1/64 per scan
+#define TSI_NOISE_MAX_DELTA			(255U)		// Deviations are clamped before squaring
+#define TSI_TOUCH_SIGMA				(6U)		// Touch above baseline + 6 sigma, release below half that
+#define TSI_BASELINE_MIN_DELTA		(10U)		// Smallest touch threshold in counts
+#define TSI_BASELINE_MAX_TOUCH		(10000U)	// Scans a touch may last before it is taken as drift
+
+typedef struct tsi_baseline
+{
+	uint32_t baseline;			// Untouched counter, Q8
+	uint32_t variance;			// Noise variance of the untouched counter, Q8
+	uint16_t touchDelta;		// Counts above baseline that mean a touch
+	uint16_t releaseDelta;		// Counts above baseline that mean a release
+	uint16_t touchScans;		// Scans since the touch started
+	bool touched;
+}tsi_baseline_t;
+
 extern tsi_state_t *tsiStatePtr;
 
 #if defined(__cplusplus)
@@ -84,7 +110,35 @@ tsi_status_t TSI_SetCallbackFunc(const tsi_callback_t pCallbackFunc, void *usrDa
 
 //tsi_status_t TSI_SaveConfiguration(uint32_t instance, const tsi_mode_t mode, tsi_operation_mode_t *operationMode);
 
-uint32_t TSI_GetUnTouchBaseline(uint8_t * tsiChn);
+/****************************************************
+* @name: TSI_BaselineInit
+*
+* @description: seed one tracker per electrode from
+*               TSI_THRESHOLD_SAMPLING blocking scans, taking the
+*               mean as the baseline and the spread as the noise.
+*               The electrodes must be untouched meanwhile.
+*
+* @param: baseline -- one tracker per electrode
+*         tsiChn -- electrode channel numbers
+*         count -- number of electrodes
+*
+* @return: tsi_status_t
+*/
+tsi_status_t TSI_BaselineInit(tsi_baseline_t *baseline, const uint8_t *tsiChn, uint8_t count);
+
+/****************************************************
+* @name: TSI_BaselineUpdate
+*
+* @description: feed one scan result to an electrode's tracker.
+*               A tracker that was never seeded (touchDelta 0)
+*               takes the reading as its baseline.
+*
+* @param: baseline -- tracker of the electrode
+*         counter -- counter of the latest scan
+*
+* @return: true while the electrode is touched
+*/
+bool TSI_BaselineUpdate(tsi_baseline_t *baseline, uint16_t counter);
 
 #if defined(__cplusplus)
 }
@@ -25,7 +25,17 @@ extern "C" {
 
 #define DEFAULT_BUS_CLOCK       24000000u
 
+#define UART0_TX_BUF_SIZE		(256U)		// Rounded up to a power of two by cb_Init
+#define UART0_RX_BUF_SIZE		(128U)		// Rounded up to a power of two by cb_Init
+
 #define ENABLE_UART0_DMA		UART0_C5 |= UART0_C5_TDMAE_MASK | UART0_C5_RDMAE_MASK
+#define ENABLE_UART0_TX_DMA		UART0_C5 |= UART0_C5_TDMAE_MASK
+
+#define UART0_TX_DMA_ENABLE		(1)			// Drain the TX buffer by DMA instead of TDRE interrupts
+#define UART0_TX_DMA_SOURCE		(3U)		// DMAMUX request source of UART0 transmit
+
+/* Called from the UART0 ISR when an idle line ends a received frame */
+typedef void (*uart0_rx_callback_t)(uint32_t length);
   
 extern void uart0_Init( uint32_t ulBaudRate,
 					   uint8_t  ucParityEnable,
@@ -34,6 +44,9 @@ extern void uart0_Init( uint32_t ulBaudRate,
 					   uint8_t  ucStopBit);
 					   
 extern void uart0_TranCtl( uint8_t ucTxEnable, uint8_t ucRxEnable);
+extern void uart0_TxStart(void);
+extern void uart0_SetRxCallback(uart0_rx_callback_t callback);
+extern uint32_t uart0_Read(uint8_t *pBuf, uint32_t max);
 void log_Raw(uint8_t ucCh);
 extern void UART0_IRQHandler(void);	
 
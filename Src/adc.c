@@ -8,14 +8,195 @@ uint32_t adcr100m = 0;               // calibrated conversion value of 100mV
 
 adc16_Conv_Config_t adcUserConfig;
 
+#if !FLASH_RAM_STANDIN
+/* The flash sector of the calibration record. Being a whole sector and
+ * sector aligned, it keeps the linker from putting anything else in the
+ * sector that temp_SaveCalibration erases. Volatile since the flash
+ * controller rewrites it: reads must not be folded to the 0xFF image. */
+const volatile uint8_t adcCalSector[FLASH_SECTOR_SIZE]
+	__attribute__((section(".rodata.adc_cal"), aligned(FLASH_SECTOR_SIZE))) =
+	{[0 ... FLASH_SECTOR_SIZE - 1U] = 0xFFU};
+#endif
+
+#if ADC_CALIBRATION_ENABLE
+/* Gain from the last self-calibration, for temp_SaveCalibration */
+static adc_calibration_param_t adcCalParam;
+static bool adcCalParamValid = false;
+#endif
+
+/* Raw code to centi-degree table, built by temp_CalibrateParam. Entry i
+ * holds the temperature at code tempLutBase + (i << tempLutShift). */
+static int16_t tempLut[TEMP_LUT_SEGMENTS + 1U];
+static uint32_t tempLutBase = 0;
+static uint32_t tempLutShift = 0;
+
+/****************************************************
+* @name: temp_CentiFromRaw
+*
+* @description: reference conversion from the temperature sensor
+*               slope, with 64-bit division. Only used to build the
+*               table.
+*
+* @param: adcValue -- raw ADC code
+*
+* @return: temperature in 0.01 oC
+*/
+static int32_t temp_CentiFromRaw(uint32_t adcValue)
+{
+	return (int32_t)(STANDARD_TEMP * 100 -
+					 ((int64_t)adcValue - (int64_t)adcrTemp25) * 10000000 / (int64_t)(adcr100m * M));
+}
+
+/****************************************************
+* @name: temp_BuildLut
+*
+* @description: fill tempLut over TEMP_LUT_MIN_CENTI..TEMP_LUT_MAX_CENTI,
+*               using the smallest power-of-two code step that covers
+*               the range with TEMP_LUT_SEGMENTS segments
+*/
+static void temp_BuildLut(void)
+{
+	uint32_t codeHot, codeCold, i;
+	
+	/* The sensor voltage falls as the temperature rises, so the hot
+	 * end of the range has the lowest code:
+	 * code = ADCR_TEMP25 + (25 - T) * M * ADCR_100M / 100000 */
+	codeHot  = (uint32_t)((int32_t)adcrTemp25 -
+			   (TEMP_LUT_MAX_CENTI - STANDARD_TEMP * 100) * (int32_t)M / 100 * (int32_t)adcr100m / 100000);
+	codeCold = (uint32_t)((int32_t)adcrTemp25 +
+			   (STANDARD_TEMP * 100 - TEMP_LUT_MIN_CENTI) * (int32_t)M / 100 * (int32_t)adcr100m / 100000);
+	tempLutBase = codeHot;
+	tempLutShift = 0;
+	while(((codeCold - codeHot) >> tempLutShift) >= TEMP_LUT_SEGMENTS)
+	{
+		tempLutShift++;
+	}
+	for(i = 0; i <= TEMP_LUT_SEGMENTS; i++)
+	{
+		tempLut[i] = (int16_t)temp_CentiFromRaw(tempLutBase + (i << tempLutShift));
+	}
+}
+
 void app_ADCInit(void)
 {
+	flash_status_t status;
+
 	ADC_ConfigDefaultMode(&adcUserConfig);
 #if ADC16_HARDWARE_AVERAGE_ENABLE
 	adcUserConfig.hwAverageEnable = true;	
 #endif
 	ADC_Init(&adcUserConfig);
-	temp_CalibrateParam();
+	/* Self-calibration and the bandgap measurement take a few ms,
+	 * only redo them when there is no usable record */
+	if(!temp_LoadCalibration())
+	{
+		temp_CalibrateParam();
+		status = temp_SaveCalibration();
+		if(status != status_FLASH_Success)
+		{
+			LOG_WRN(MOD_ADC, Event1, TEMP_CALIBRATION_NOT_SAVED, (int32_t)status);
+		}
+	}
+}
+
+/****************************************************
+* @name: temp_ConfigId
+*
+* @description: fingerprint of the converter configuration the
+*               calibration was taken with
+*/
+static uint32_t temp_ConfigId(void)
+{
+	return my_crc32((const uint8_t *)&adcUserConfig, sizeof(adcUserConfig));
+}
+
+/****************************************************
+* @name: temp_LoadCalibration
+*
+* @description: restore the ADC gain and the temperature sensor
+*               coefficients from the flash record
+*
+* @return: false if the record is missing, stale or corrupt
+*/
+bool temp_LoadCalibration(void)
+{
+	adc_cal_record_t record;
+#if ADC_CALIBRATION_ENABLE
+	adc_calibration_param_t adcCalibrationParam;
+#endif
+
+	if(flash_Read(ADC_CAL_FLASH_ADDR, &record, sizeof(record)) != status_FLASH_Success)
+	{
+		return false;
+	}
+	if((record.magic != ADC_CAL_MAGIC) ||
+	   (record.version != ADC_CAL_RECORD_VERSION) ||
+	   (record.crc != my_crc32((const uint8_t *)&record, offsetof(adc_cal_record_t, crc))) ||
+	   (record.configId != temp_ConfigId()) ||
+	   (record.adcr100m == 0))
+	{
+		return false;
+	}
+#if ADC_CALIBRATION_ENABLE
+	adcCalibrationParam.plusSideGainValue = record.plusSideGainValue;
+#if ADC16_DIFF_MODE_ENABLE
+	adcCalibrationParam.minusSideGainValue = record.minusSideGainValue;
+#endif
+	ADC_SetCalibrationParam(&adcCalibrationParam);
+	adcCalParam = adcCalibrationParam;
+	adcCalParamValid = true;
+#endif
+	adcrTemp25 = record.adcrTemp25;
+	adcr100m = record.adcr100m;
+	temp_BuildLut();
+	LOG_DBG(MOD_ADC, Int, (uint8_t *)"adc temp25 from flash ", adcrTemp25);
+	return true;
+}
+
+/****************************************************
+* @name: temp_SaveCalibration
+*
+* @description: write the current calibration to the flash record,
+*               after a successful temp_CalibrateParam
+*
+* @return: flash_status_t, status_FLASH_InvalidArgument if there
+*          is no calibration to save
+*/
+flash_status_t temp_SaveCalibration(void)
+{
+	adc_cal_record_t record;
+	flash_status_t status;
+
+#if ADC_CALIBRATION_ENABLE
+	if(!adcCalParamValid)
+	{
+		return status_FLASH_InvalidArgument;
+	}
+#endif
+	if(adcr100m == 0)
+	{
+		return status_FLASH_InvalidArgument;
+	}
+	memset(&record, 0xFF, sizeof(record));
+	record.magic = ADC_CAL_MAGIC;
+	record.version = ADC_CAL_RECORD_VERSION;
+#if ADC_CALIBRATION_ENABLE
+	record.plusSideGainValue = adcCalParam.plusSideGainValue;
+#if ADC16_DIFF_MODE_ENABLE
+	record.minusSideGainValue = adcCalParam.minusSideGainValue;
+#endif
+#endif
+	record.configId = temp_ConfigId();
+	record.adcrTemp25 = adcrTemp25;
+	record.adcr100m = adcr100m;
+	record.crc = my_crc32((const uint8_t *)&record, offsetof(adc_cal_record_t, crc));
+
+	status = flash_EraseSector(ADC_CAL_FLASH_ADDR);
+	if(status != status_FLASH_Success)
+	{
+		return status;
+	}
+	return flash_Program(ADC_CAL_FLASH_ADDR, (const uint32_t *)&record, sizeof(record) / 4U);
 }
 
 void temp_CalibrateParam(void)
@@ -35,8 +216,9 @@ void temp_CalibrateParam(void)
   pmcBandgapConfig.drive = kPmcBandgapBufferDriveLow,
 #endif
 #if ADC_CALIBRATION_ENABLE
-	ADC_GetCalibrationParam(&adcCalibrationParam);
+	adcCalParamValid = (ADC_GetCalibrationParam(&adcCalibrationParam) == status_ADC16_Success);
 	ADC_SetCalibrationParam(&adcCalibrationParam);
+	adcCalParam = adcCalibrationParam;
 #endif
 	// Enable BANDGAP reference voltage
     PMC_HAL_BandgapBufferConfig(&pmcBandgapConfig);
@@ -58,16 +240,115 @@ void temp_CalibrateParam(void)
     // Calculate conversion value of 100mV.
     // ADCR_100M = ADCR_VDD x 100 / VDD
     adcr100m = ADCR_VDD*100/ vdd;
+    LOG_DBG(MOD_ADC, Int, (uint8_t *)"adc bandgap ", bandgapValue);
+    LOG_DBG(MOD_ADC, Int, (uint8_t *)"adc temp25 ", adcrTemp25);
+    temp_BuildLut();
 
     // Disable BANDGAP reference voltage
     pmcBandgapConfig.enable = false;
     PMC_HAL_BandgapBufferConfig(&pmcBandgapConfig);
 }
 
+/****************************************************
+* @name: temp_ConvertRaw
+*
+* @description: convert a raw temperature sensor code with a table
+*               lookup and linear interpolation, no division
+*
+* @param: adcValue -- raw ADC code
+*
+* @return: temperature in 0.01 oC
+*/
+int32_t temp_ConvertRaw(uint32_t adcValue)
+{
+	uint32_t offset, idx, frac;
+	int32_t delta;
+	
+	if(adcValue <= tempLutBase)
+	{
+		return tempLut[0];
+	}
+	offset = adcValue - tempLutBase;
+	idx = offset >> tempLutShift;
+	if(idx >= TEMP_LUT_SEGMENTS)
+	{
+		return tempLut[TEMP_LUT_SEGMENTS];
+	}
+	frac = offset & ((1U << tempLutShift) - 1U);
+	/* The table falls with rising codes, interpolate on the magnitude */
+	delta = (int32_t)tempLut[idx] - (int32_t)tempLut[idx + 1U];
+	return (int32_t)tempLut[idx] - (int32_t)(((uint32_t)delta * frac) >> tempLutShift);
+}
+
+/****************************************************
+* @name: temp_CentiToRaw
+*
+* @description: raw temperature sensor code of a temperature, the
+*               inverse of temp_ConvertRaw. Uses 64-bit math, for
+*               setting up thresholds rather than per reading.
+*
+* @param: centi -- temperature in 0.01 oC
+*
+* @return: raw ADC code, clamped to 16 bits
+*/
+uint16_t temp_CentiToRaw(int32_t centi)
+{
+	int64_t code = (int64_t)adcrTemp25 +
+				   ((int64_t)(STANDARD_TEMP * 100 - centi) * (int64_t)(adcr100m * M)) / 10000000;
+	
+	if(code < 0)
+	{
+		return 0U;
+	}
+	return (code > 0xFFFF) ? 0xFFFFU : (uint16_t)code;
+}
+
+/****************************************************
+* @name: temp_StartAlarm
+*
+* @description: supervise the temperature with the ADC compare
+*               function. With wakeInside false, a conversion only
+*               completes (and calls back) once the reading leaves
+*               lowCenti..highCenti; with wakeInside true, once it is
+*               back inside. Hotter means a lower code, so the window
+*               is flipped into codes here.
+*
+* @param: lowCenti, highCenti -- window in 0.01 oC
+*         wakeInside -- complete inside instead of outside the window
+*         trigger, periodUs -- pacing, see ADC_StartMonitor
+*         callback -- called from the ADC ISR with the raw code
+*
+* @return: ADC_StartMonitor status
+*/
+adc16_Status_t temp_StartAlarm(int32_t lowCenti,
+							   int32_t highCenti,
+							   bool wakeInside,
+							   adc_hw_trigger_t trigger,
+							   uint32_t periodUs,
+							   adc_conv_callback_t callback)
+{
+	adc16_Hw_Cmp_Config_t cmpConfig;
+	
+	cmpConfig.hwCmpEnable = true;
+	cmpConfig.hwCmpRangeEnable = true;
+	/* CV1 <= CV2: ACFGT clear compares outside (result < CV1 or > CV2),
+	 * ACFGT set compares inside (CV1 <= result <= CV2) */
+	cmpConfig.hwCmpGreaterThanEnable = wakeInside;
+	cmpConfig.cmpValue1 = temp_CentiToRaw(highCenti);
+	cmpConfig.cmpValue2 = temp_CentiToRaw(lowCenti);
+	return ADC_StartMonitor(adc16_TempSensor, &cmpConfig, trigger, periodUs, callback);
+}
+
+/****************************************************
+* @name: read_OnChipTemperature
+*
+* @description: measure the on-chip temperature sensor
+*
+* @return: temperature in 0.01 oC
+*/
 int32_t read_OnChipTemperature(void)
 {
 	uint32_t adcValue = 0;
-	int32_t currentTemp = 0;
 	adc16_Ch_Config_t adcChConfig;
 	adcChConfig.ch_Idx	= adc16_TempSensor;
 #if ADC16_DIFF_MODE_ENABLE
@@ -77,7 +358,6 @@ int32_t read_OnChipTemperature(void)
 	ADC_ConfigCh(&adcChConfig);
 	ADC_WaitForConvComplete();
 	adcValue = ADC_GetConvValueSigned();
-	currentTemp = (int32_t)(STANDARD_TEMP - ((int32_t)adcValue - (int32_t)adcrTemp25) * 100000 /(int32_t)(adcr100m*M));
 	ADC_PauseConv();
-	return currentTemp;
+	return temp_ConvertRaw(adcValue);
 }
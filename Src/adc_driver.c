@@ -1,4 +1,27 @@
 #include "includes.h"
+
+static volatile adc_conv_callback_t adcConvCallback = NULL;	// Set while an ADC_StartConv conversion runs
+static adc16_Ch_t adcConvCh;
+static adc_hw_trigger_t adcTrigger = adcTriggerSoftware;	// Trigger of the running conversions
+static bool adcContinuous = false;							// Software-triggered monitor running
+
+#if ADC16_DMA_ENABLE
+/* Scan engine: channel resultCh moves each result from ADC0_RA into the
+ * sample buffer, then links to channel seqCh, which writes the next
+ * entry of seqBuf to ADC0_SC1A and so starts the next conversion. The
+ * DMA here has no half-transfer interrupt, so each half of the buffer
+ * is one transfer and the ISR re-arms both channels for the other half. */
+static struct
+{
+	adc_scan_config_t config;
+	uint8_t *seqBuf;				// SC1A values, one per sample, one ahead of the results
+	uint32_t perHalf;				// Samples per half buffer
+	uint8_t half;					// Half being filled
+	uint8_t resultCh;
+	uint8_t seqCh;
+	volatile bool running;
+}adcScan;
+#endif
  
  //fill the default configuration for a one-time trigger mode
 adc16_Status_t ADC_ConfigDefaultMode(adc16_Conv_Config_t *userConfigPtr)
@@ -69,6 +92,315 @@ void ADC_WaitForConvComplete(void)
 	{}
 }
  
+adc16_Status_t ADC_StartConv(adc16_Ch_t ch, adc_conv_callback_t callback)
+{
+	adc16_Ch_Config_t config;
+	
+	if(!callback)
+	{
+		return status_ADC16_InValidArgument;
+	}
+	if(adcConvCallback
+#if ADC16_DMA_ENABLE
+	   || adcScan.running
+#endif
+	   )
+	{
+		return status_ADC16_Busy;
+	}
+	adcConvCh = ch;
+	adcConvCallback = callback;
+	config.ch_Idx = ch;
+	config.convCompleteIntEnable = true;
+#if ADC16_DIFF_MODE_ENABLE
+	config.diffModeEnable = false;
+#endif
+	ADC_ConfigCh(&config);		// Writing SC1A starts the conversion
+	return status_ADC16_Success;
+}
+
+bool ADC_IsConvPending(void)
+{
+	return adcConvCallback != NULL;
+}
+
+/* A hardware trigger the ADC may not take: PIT0 is the task tick, and a
+ * PIT trigger needs a period */
+static bool ADC_TriggerInvalid(adc_hw_trigger_t trigger, uint32_t periodUs)
+{
+	return (trigger == adcTriggerPit0) || ((trigger == adcTriggerPit1) && (periodUs == 0));
+}
+
+/* Route conversion starts to trigger. PIT triggers also get their
+ * timer started at periodUs with its interrupt off. */
+static void ADC_ConfigTrigger(adc_hw_trigger_t trigger, uint32_t periodUs)
+{
+	adcTrigger = trigger;
+	if(trigger == adcTriggerSoftware)
+	{
+		adc16_Hal_EnableHwTrigger(false);
+		SIM_SOPT7 &= ~(SIM_SOPT7_ADC0ALTTRGEN_MASK | SIM_SOPT7_ADC0TRGSEL_MASK);
+		return;
+	}
+	SIM_SOPT7 = (SIM_SOPT7 & ~(SIM_SOPT7_ADC0TRGSEL_MASK | SIM_SOPT7_ADC0PRETRGSEL_MASK)) |
+				SIM_SOPT7_ADC0ALTTRGEN_MASK | SIM_SOPT7_ADC0TRGSEL(trigger);	// Pre-trigger A, result in RA
+	adc16_Hal_EnableHwTrigger(true);
+	if((trigger == adcTriggerPit0) || (trigger == adcTriggerPit1))
+	{
+		PIT_SetTimerPeriodByUs(trigger - adcTriggerPit0, periodUs);
+		PIT_Hal_SetIntCmd(trigger - adcTriggerPit0, false);
+		PIT_StartTimer(trigger - adcTriggerPit0);
+	}
+}
+
+static void ADC_StopTrigger(void)
+{
+	if((adcTrigger == adcTriggerPit0) || (adcTrigger == adcTriggerPit1))
+	{
+		PIT_StopTimer(adcTrigger - adcTriggerPit0);
+	}
+	ADC_ConfigTrigger(adcTriggerSoftware, 0U);
+}
+
+adc16_Status_t ADC_StartTriggered(adc16_Ch_t ch,
+								  adc_hw_trigger_t trigger,
+								  uint32_t periodUs,
+								  adc_conv_callback_t callback)
+{
+	adc16_Ch_Config_t config;
+	
+	if((!callback) || (trigger == adcTriggerSoftware) || ADC_TriggerInvalid(trigger, periodUs))
+	{
+		return status_ADC16_InValidArgument;
+	}
+	if(adcConvCallback
+#if ADC16_DMA_ENABLE
+	   || adcScan.running
+#endif
+	   )
+	{
+		return status_ADC16_Busy;
+	}
+	adcConvCh = ch;
+	adcConvCallback = callback;
+	/* With ADTRG set the SC1A write only arms the channel */
+	adc16_Hal_EnableHwTrigger(true);
+	config.ch_Idx = ch;
+	config.convCompleteIntEnable = true;
+#if ADC16_DIFF_MODE_ENABLE
+	config.diffModeEnable = false;
+#endif
+	ADC_ConfigCh(&config);
+	ADC_ConfigTrigger(trigger, periodUs);
+	return status_ADC16_Success;
+}
+
+void ADC_StopTriggered(void)
+{
+	if((adcTrigger == adcTriggerSoftware) || (!adcConvCallback))
+	{
+		return;
+	}
+	ADC_StopTrigger();
+	ADC_PauseConv();
+	adcConvCallback = NULL;
+}
+
+adc16_Status_t ADC_StartMonitor(adc16_Ch_t ch,
+								const adc16_Hw_Cmp_Config_t *cmpConfigPtr,
+								adc_hw_trigger_t trigger,
+								uint32_t periodUs,
+								adc_conv_callback_t callback)
+{
+	adc16_Status_t status;
+	
+	if((!cmpConfigPtr) || (!callback) || ADC_TriggerInvalid(trigger, periodUs))
+	{
+		return status_ADC16_InValidArgument;
+	}
+	if(adcConvCallback
+#if ADC16_DMA_ENABLE
+	   || adcScan.running
+#endif
+	   )
+	{
+		return status_ADC16_Busy;
+	}
+	adc16_Hal_ConfigHwCmp(cmpConfigPtr);
+	if(trigger == adcTriggerSoftware)
+	{
+		adcContinuous = true;
+		adc16_Hal_EnableContinuous(true);
+		status = ADC_StartConv(ch, callback);
+	}
+	else
+	{
+		status = ADC_StartTriggered(ch, trigger, periodUs, callback);
+	}
+	if(status != status_ADC16_Success)
+	{
+		ADC_StopMonitor();
+	}
+	return status;
+}
+
+void ADC_StopMonitor(void)
+{
+	static const adc16_Hw_Cmp_Config_t cmpOff = {false, false, false, 0U, 0U};
+	
+	if(adcContinuous)
+	{
+		adcContinuous = false;
+		adc16_Hal_EnableContinuous(false);
+		ADC_PauseConv();
+		adcConvCallback = NULL;
+	}
+	else
+	{
+		ADC_StopTriggered();
+	}
+	adc16_Hal_ConfigHwCmp(&cmpOff);
+}
+
+void ADC0_IRQHandler(void)
+{
+	adc_conv_callback_t callback = adcConvCallback;
+	uint16_t value = adc16_Hal_GetConvValue();	// Reading the result clears COCO
+	
+	/* Triggered and continuous conversions keep running */
+	if((adcTrigger == adcTriggerSoftware) && (!adcContinuous))
+	{
+		ADC_PauseConv();
+		adcConvCallback = NULL;
+	}
+	if(callback)
+	{
+		callback(adcConvCh, value);
+	}
+}
+
+#if ADC16_DMA_ENABLE
+static void ADC_ScanArm(uint8_t half)
+{
+	uint32_t offset = half * adcScan.perHalf;
+	
+	DMA_DSR_BCR_REG(DMA_BASE_PTR, adcScan.seqCh) |= DMA_DSR_BCR_DONE_MASK;
+	DMA_SAR_REG(DMA_BASE_PTR, adcScan.seqCh) = (uint32_t)&adcScan.seqBuf[offset];
+	DMA_DSR_BCR_REG(DMA_BASE_PTR, adcScan.seqCh) = DMA_DSR_BCR_BCR(adcScan.perHalf);
+	DMA_DAR_REG(DMA_BASE_PTR, adcScan.resultCh) = (uint32_t)&adcScan.config.sampleBuf[offset];
+	DMA_DSR_BCR_REG(DMA_BASE_PTR, adcScan.resultCh) = DMA_DSR_BCR_BCR(adcScan.perHalf * sizeof(uint16_t));
+	DMA_DCR_REG(DMA_BASE_PTR, adcScan.resultCh) |= DMA_DCR_ERQ_MASK;
+	adcScan.half = half;
+}
+
+static void ADC_ScanDmaComplete(uint8_t dma_ch)
+{
+	uint8_t done = adcScan.half;
+	
+	if(!adcScan.running)
+	{
+		return;
+	}
+	/* The linked sequence write follows the last result right away */
+	while(DMA_DSR_BCR_REG(DMA_BASE_PTR, adcScan.seqCh) & DMA_DSR_BCR_BSY_MASK)
+	{}
+	/* A result that completes meanwhile holds its DMA request until ERQ is set again */
+	ADC_ScanArm(done ^ 1U);
+	adcScan.config.callback((adc_scan_half_t)done,
+							&adcScan.config.sampleBuf[done * adcScan.perHalf],
+							adcScan.config.framesPerHalf);
+}
+
+adc16_Status_t ADC_ScanStart(const adc_scan_config_t *configPtr)
+{
+	uint32_t i;
+	
+	if((!configPtr) || (!configPtr->chList) || (!configPtr->sampleBuf) || (!configPtr->callback) ||
+	   (configPtr->chCount == 0) || (configPtr->chCount > ADC_SCAN_MAX_CH) || (configPtr->framesPerHalf == 0) ||
+	   ADC_TriggerInvalid(configPtr->trigger, configPtr->periodUs))
+	{
+		return status_ADC16_InValidArgument;
+	}
+	if(adcConvCallback || adcScan.running)
+	{
+		return status_ADC16_Busy;
+	}
+	adcScan.config = *configPtr;
+	adcScan.perHalf = configPtr->framesPerHalf * configPtr->chCount;
+	adcScan.seqBuf = (uint8_t *)malloc(sizeof(uint8_t) * 2U * adcScan.perHalf);
+	if(!adcScan.seqBuf)
+	{
+		return status_ADC16_Failed;
+	}
+	for(i = 0; i < 2U * adcScan.perHalf; i++)
+	{
+		adcScan.seqBuf[i] = (uint8_t)ADC_SC1_ADCH(configPtr->chList[(i + 1U) % configPtr->chCount]);
+	}
+	adcScan.resultCh = dma_ChannelAlloc();
+	adcScan.seqCh = dma_ChannelAlloc();
+	if((adcScan.resultCh == DMA_CHANNEL_NONE) || (adcScan.seqCh == DMA_CHANNEL_NONE))
+	{
+		if(adcScan.resultCh != DMA_CHANNEL_NONE)
+		{
+			dma_ChannelFree(adcScan.resultCh);
+		}
+		free(adcScan.seqBuf);
+		adcScan.seqBuf = NULL;
+		return status_ADC16_Busy;
+	}
+	
+	/* Sequence channel: byte writes to SC1A, started only by the link */
+	dma_Init_Mem2mem(adcScan.seqCh, adcScan.seqBuf, (uint8_t *)&ADC0_SC1A, adcScan.perHalf);
+	DMA_DCR_REG(DMA_BASE_PTR, adcScan.seqCh) &= ~(DMA_DCR_DINC_MASK | DMA_DCR_EINT_MASK);
+	DMA_DCR_REG(DMA_BASE_PTR, adcScan.seqCh) |= DMA_DCR_CS_MASK;
+	
+	/* Result channel: 16-bit reads of RA on each ADC request, linked to the
+	 * sequence channel after every transfer, ERQ dropped at the end of a half */
+	dma_SetCallback(adcScan.resultCh, ADC_ScanDmaComplete);
+	dma_Init_Per2Mem(adcScan.resultCh, ADC_DMA_SOURCE, (uint8_t *)&ADC0_RA,
+					 (uint8_t *)adcScan.config.sampleBuf, adcScan.perHalf * sizeof(uint16_t));
+	DMA_DCR_REG(DMA_BASE_PTR, adcScan.resultCh) &= ~(DMA_DCR_SSIZE_MASK | DMA_DCR_DSIZE_MASK);
+	DMA_DCR_REG(DMA_BASE_PTR, adcScan.resultCh) |= DMA_DCR_SSIZE(2) | DMA_DCR_DSIZE(2) |
+												   DMA_DCR_D_REQ_MASK |
+												   DMA_DCR_LINKCC(2) | DMA_DCR_LCH1(adcScan.seqCh);
+	ADC_ScanArm(0U);
+	adcScan.running = true;
+	
+	/* Start (or with a hardware trigger, arm) the first conversion, the
+	 * DMA keeps it going */
+	adc16_Hal_EnableDma(true);
+	if(configPtr->trigger != adcTriggerSoftware)
+	{
+		adc16_Hal_EnableHwTrigger(true);
+	}
+	ADC0_SC1A = ADC_SC1_ADCH(configPtr->chList[0]);
+	if(configPtr->trigger != adcTriggerSoftware)
+	{
+		ADC_ConfigTrigger(configPtr->trigger, configPtr->periodUs);
+	}
+	return status_ADC16_Success;
+}
+
+void ADC_ScanStop(void)
+{
+	if(!adcScan.running)
+	{
+		return;
+	}
+	adcScan.running = false;
+	ADC_StopTrigger();
+	DMA_DCR_REG(DMA_BASE_PTR, adcScan.resultCh) &= ~(DMA_DCR_ERQ_MASK | DMA_DCR_LINKCC_MASK);
+	DMAMUX0_CHCFG(adcScan.resultCh) = 0x00;
+	adc16_Hal_EnableDma(false);
+	ADC_PauseConv();
+	dma_SetCallback(adcScan.resultCh, NULL);
+	dma_ChannelFree(adcScan.resultCh);
+	dma_ChannelFree(adcScan.seqCh);
+	free(adcScan.seqBuf);
+	adcScan.seqBuf = NULL;
+}
+#endif /* ADC16_DMA_ENABLE */
+ 
 void ADC_PauseConv(void)
 {
 	adc16_Ch_Config_t config;
@@ -10,7 +10,7 @@ void adc16_Hal_Init(void){
 }
 
 void adc16_Hal_ConfigCh(const adc16_Ch_Config_t *configPtr){
-	uint16_t sc1;
+	uint16_t sc1 = 0U;
 	if(configPtr->convCompleteIntEnable){
 		sc1 |= ADC_SC1_AIEN_MASK;
 	}
@@ -125,7 +125,7 @@ void adc16_Hal_ConfigHwCmp(const adc16_Hw_Cmp_Config_t *configPtr){
     /* Compare Function Enable. */
     if (configPtr->hwCmpEnable)
     {
-        sc2 = ADC_SC2_ACFE_MASK;
+        sc2 |= ADC_SC2_ACFE_MASK;
     }
     /* Compare Function Greater Than Enable. */
     if (configPtr->hwCmpGreaterThanEnable)
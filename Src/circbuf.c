@@ -0,0 +1,243 @@
+/***************************************************************************
+ *
+ *	Filename: 		circbuf.c
+ *  Description:  	circular buffer functions implementation
+ *
+ *****************************************************************************/
+
+#include "includes.h"
+
+#define CB_UNITTEST_SIZE	(16U)
+
+/****************************************************
+* @name: cb_RoundUpPow2
+*
+* @description: round a size up to the next power of two
+*
+* @param: num -- size to round up, at most CB_MAX_ITEMS
+*
+* @return: smallest power of two not less than num
+*/
+static uint32_t cb_RoundUpPow2(uint32_t num){
+	uint32_t size = 1U;
+	while(size < num)
+		size <<= 1;
+	return size;
+}
+
+CB_e cb_IsFull(CircBuf_t * cb){
+	if((cb->tail - cb->head) == cb->size)
+		return FULL;
+	return NORMAL;
+}
+
+CB_e cb_IsEmpty(CircBuf_t * cb){
+	if(cb->tail == cb->head)
+		return EMPTY;
+	return NORMAL;
+}
+
+uint32_t cb_Length(CircBuf_t * cb){
+	return cb->tail - cb->head;
+}
+
+CB_e cb_Enqueue(CircBuf_t * cb, uint8_t data){
+	if((cb->tail - cb->head) == cb->size)
+		return OVERFILL;
+	cb->buffer[cb->tail & cb->mask] = data;
+	SYS_MemoryBarrier();
+	cb->tail++;
+	return NORMAL;
+}
+
+CB_e cb_Dequeue(CircBuf_t * cb, uint8_t *output){
+	if(cb->tail == cb->head)
+		return UNDERDEQUEUE;
+	SYS_MemoryBarrier();
+	*output = cb->buffer[cb->head & cb->mask];
+	SYS_MemoryBarrier();
+	cb->head++;
+	return NORMAL;
+}
+
+uint32_t cb_EnqueueBulk(CircBuf_t * cb, const uint8_t * data, uint32_t num){
+	uint32_t space = cb->size - (cb->tail - cb->head);
+	uint32_t offset = cb->tail & cb->mask;
+	uint32_t first;
+
+	if(num > space)
+		num = space;
+	/* Copy up to the end of the buffer memory, then wrap to the start */
+	first = cb->size - offset;
+	if(first > num)
+		first = num;
+	memcpy(cb->buffer + offset, data, first);
+	memcpy(cb->buffer, data + first, num - first);
+	SYS_MemoryBarrier();
+	cb->tail += num;
+	return num;
+}
+
+uint32_t cb_DequeueBulk(CircBuf_t * cb, uint8_t * output, uint32_t num){
+	uint32_t count = cb->tail - cb->head;
+	uint32_t offset = cb->head & cb->mask;
+	uint32_t first;
+
+	if(num > count)
+		num = count;
+	SYS_MemoryBarrier();
+	/* Copy up to the end of the buffer memory, then wrap to the start */
+	first = cb->size - offset;
+	if(first > num)
+		first = num;
+	memcpy(output, cb->buffer + offset, first);
+	memcpy(output + first, cb->buffer, num - first);
+	SYS_MemoryBarrier();
+	cb->head += num;
+	return num;
+}
+
+CB_e cb_PeekContiguous(CircBuf_t * cb, uint8_t ** ptr, uint32_t * len){
+	uint32_t count = cb->tail - cb->head;
+	uint32_t offset = cb->head & cb->mask;
+
+	/* Stop at the end of the buffer memory */
+	if(count > cb->size - offset)
+		count = cb->size - offset;
+	SYS_MemoryBarrier();
+	*ptr = cb->buffer + offset;
+	*len = count;
+	return (count == 0) ? EMPTY : NORMAL;
+}
+
+void cb_Commit(CircBuf_t * cb, uint32_t num){
+	assert(num <= cb->tail - cb->head);
+	SYS_MemoryBarrier();
+	cb->head += num;
+}
+
+CB_e cb_Reserve(CircBuf_t * cb, uint8_t ** ptr, uint32_t * len){
+	uint32_t space = cb->size - (cb->tail - cb->head);
+	uint32_t offset = cb->tail & cb->mask;
+
+	/* Stop at the end of the buffer memory */
+	if(space > cb->size - offset)
+		space = cb->size - offset;
+	*ptr = cb->buffer + offset;
+	*len = space;
+	return (space == 0) ? FULL : NORMAL;
+}
+
+void cb_Publish(CircBuf_t * cb, uint32_t num){
+	assert(num <= cb->size - (cb->tail - cb->head));
+	SYS_MemoryBarrier();
+	cb->tail += num;
+}
+
+CircBuf_t * cb_Init(CircBuf_t * cb, uint32_t num_items){
+	/* Above 2^31 the size can't be doubled without overflowing */
+	if((cb == NULL) || (num_items == 0) || (num_items > CB_MAX_ITEMS))
+		return NULL;
+	cb->size = cb_RoundUpPow2(num_items);
+	cb->mask = cb->size - 1U;
+	cb->head = 0;
+	cb->tail = 0;
+	cb->buffer = (uint8_t *)malloc(sizeof(uint8_t)*cb->size);
+	if(cb->buffer == NULL)
+		return NULL;
+	return cb;
+}
+
+CB_e cb_Destroy(CircBuf_t * cb){
+	if((cb == NULL) || (cb->buffer == NULL))
+		return FREE_ERROR;
+	free(cb->buffer);
+	cb->buffer = NULL;
+	cb->size = 0;
+	cb->mask = 0;
+	cb->head = 0;
+	cb->tail = 0;
+	return FREE_SUCCESS;
+}
+
+void cb_Empty_Buff(CircBuf_t * cb){
+	cb->head = cb->tail;
+}
+
+void cb_Fill_Buff(CircBuf_t * cb){
+	uint8_t i = 0;
+	while(cb_Enqueue(cb, i) != OVERFILL)
+		i++;
+}
+
+void circBuf_UnitTest(void){
+	CircBuf_t cb;
+	uint8_t in[CB_UNITTEST_SIZE * 2];
+	uint8_t out[CB_UNITTEST_SIZE * 2];
+	uint8_t data;
+	uint8_t * ptr;
+	uint32_t i, shift, len;
+
+	for(i = 0; i < sizeof(in); i++)
+		in[i] = (uint8_t)(i * 7 + 1);
+
+	/* Size is rounded up to a power of two */
+	assert(cb_Init(&cb, CB_UNITTEST_SIZE - 3) == &cb);
+	assert(cb.size == CB_UNITTEST_SIZE);
+	assert(cb_IsEmpty(&cb) == EMPTY);
+	assert(cb_Dequeue(&cb, &data) == UNDERDEQUEUE);
+
+	/* Byte-wise fill and drain */
+	cb_Fill_Buff(&cb);
+	assert(cb_IsFull(&cb) == FULL);
+	assert(cb_Enqueue(&cb, 0xAA) == OVERFILL);
+	for(i = 0; i < CB_UNITTEST_SIZE; i++){
+		assert(cb_Dequeue(&cb, &data) == NORMAL);
+		assert(data == (uint8_t)i);
+	}
+	assert(cb_IsEmpty(&cb) == EMPTY);
+
+	/* Bulk copies at every wrap position must match byte-wise order */
+	for(shift = 0; shift < CB_UNITTEST_SIZE; shift++){
+		cb_Empty_Buff(&cb);
+		for(i = 0; i < shift; i++){
+			cb_Enqueue(&cb, 0);
+			cb_Dequeue(&cb, &data);
+		}
+		assert(cb_EnqueueBulk(&cb, in, sizeof(in)) == CB_UNITTEST_SIZE);
+		assert(cb_IsFull(&cb) == FULL);
+		assert(cb_DequeueBulk(&cb, out, 5) == 5);
+		assert(cb_EnqueueBulk(&cb, in + CB_UNITTEST_SIZE, 5) == 5);
+		assert(cb_DequeueBulk(&cb, out + 5, sizeof(out)) == CB_UNITTEST_SIZE);
+		assert(memcmp(out, in, CB_UNITTEST_SIZE) == 0);
+		assert(memcmp(out + CB_UNITTEST_SIZE, in + CB_UNITTEST_SIZE, 5) == 0);
+		assert(cb_Length(&cb) == 0);
+	}
+
+	/* In-place access stops at the end of the buffer memory */
+	cb_Empty_Buff(&cb);
+	while((cb.tail & cb.mask) != CB_UNITTEST_SIZE - 4){
+		cb_Enqueue(&cb, 0);
+		cb_Dequeue(&cb, &data);
+	}
+	assert(cb_PeekContiguous(&cb, &ptr, &len) == EMPTY);
+	assert(cb_Reserve(&cb, &ptr, &len) == NORMAL);
+	assert(len == 4);
+	memcpy(ptr, in, len);
+	cb_Publish(&cb, len);
+	assert(cb_Reserve(&cb, &ptr, &len) == NORMAL);
+	assert(len == CB_UNITTEST_SIZE - 4);
+	memcpy(ptr, in + 4, len);
+	cb_Publish(&cb, len);
+	assert(cb_Reserve(&cb, &ptr, &len) == FULL);
+	assert(cb_PeekContiguous(&cb, &ptr, &len) == NORMAL);
+	assert((len == 4) && (memcmp(ptr, in, len) == 0));
+	cb_Commit(&cb, len);
+	assert(cb_PeekContiguous(&cb, &ptr, &len) == NORMAL);
+	assert((len == CB_UNITTEST_SIZE - 4) && (memcmp(ptr, in + 4, len) == 0));
+	cb_Commit(&cb, len);
+	assert(cb_IsEmpty(&cb) == EMPTY);
+
+	assert(cb_Destroy(&cb) == FREE_SUCCESS);
+	assert(cb_Destroy(&cb) == FREE_ERROR);
+}
@@ -0,0 +1,314 @@
+/***************************************************************************
+ *
+ *	Filename: 		data.c
+ *  Description:  	data manipulation functions implementation
+ *
+ *****************************************************************************/
+
+#include "includes.h"
+
+#define DATA_ITOA_BUF_SIZE		(33U)		// Sign plus 32 binary digits
+
+/* "00" to "99", indexed by twice the value */
+static const uint8_t data_DigitPairs[200] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+static const uint8_t data_Digits[36] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+/* Half of the last printed decimal place as a 0.64 fraction, rounded up so
+ * exact ties round away from zero */
+static const uint64_t data_HalfUlp[DATA_FTOA_MAX_DECIMALS + 1] =
+{
+	0x8000000000000000ULL, 0x0CCCCCCCCCCCCCCDULL, 0x0147AE147AE147AFULL,
+	0x0020C49BA5E353F8ULL, 0x000346DC5D638866ULL, 0x000053E2D6238DA4ULL,
+	0x000008637BD05AF7ULL, 0x000000D6BF94D5E6ULL, 0x00000015798EE231ULL,
+	0x0000000225C17D05ULL
+};
+
+/* CRC-32 of each nibble value, for my_crc32 */
+static const uint32_t data_Crc32Nibble[16] =
+{
+	0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU,
+	0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+	0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU,
+	0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU
+};
+
+/****************************************************
+* @name: data_Div100
+*
+* @description: divide by 100 with a reciprocal multiply, the
+*               M0+ has no divide instruction. Exact for all
+*               32-bit values.
+*
+* @param: num -- dividend
+*
+* @return: num / 100
+*/
+static uint32_t data_Div100(uint32_t num){
+	/* The 32-bit product is exact below 43699, which covers most
+	 * of the iterations and avoids the 64-bit multiply */
+	if(num < 43699U)
+		return (num * 5243U) >> 19;
+	return (uint32_t)(((uint64_t)num * 0x51EB851FU) >> 37);
+}
+
+/****************************************************
+* @name: data_IsDigits4
+*
+* @description: check that all four bytes of a word are '0'..'9'
+*
+* @param: word -- four characters
+*
+* @return: true if they are all decimal digits
+*/
+static bool data_IsDigits4(uint32_t word){
+	return ((word & 0xF0F0F0F0U) == 0x30303030U) &&
+		   (((word + 0x06060606U) & 0xF0F0F0F0U) == 0x30303030U);
+}
+
+/****************************************************
+* @name: data_ParseDigits4
+*
+* @description: convert four digit characters to their value,
+*               first character in the lowest byte
+*
+* @param: word -- four characters checked by data_IsDigits4
+*
+* @return: the value 0..9999
+*/
+static uint32_t data_ParseDigits4(uint32_t word){
+	word -= 0x30303030U;
+	/* Combine neighbouring digits into two bytes of 0..99 */
+	word = (word * 10U) + (word >> 8);
+	return (word & 0xFFU) * 100U + ((word >> 16) & 0xFFU);
+}
+
+/****************************************************
+* @name: data_Utoa10
+*
+* @description: write the decimal digits of num backwards, two
+*               digits per step
+*
+* @param: end -- one past the last digit position
+*         num -- value to convert
+*
+* @return: pointer to the first digit
+*/
+static uint8_t * data_Utoa10(uint8_t *end, uint32_t num){
+	uint32_t quot;
+
+	while(num >= 100U){
+		quot = data_Div100(num);
+		end -= 2;
+		memcpy(end, &data_DigitPairs[(num - quot * 100U) << 1], 2);
+		num = quot;
+	}
+	if(num >= 10U){
+		end -= 2;
+		memcpy(end, &data_DigitPairs[num << 1], 2);
+	}
+	else{
+		*--end = (uint8_t)('0' + num);
+	}
+	return end;
+}
+
+/****************************************************
+* @name: data_FixToa
+*
+* @description: format a sign, integer part and 0.64 binary
+*               fraction, rounded to the given decimal places
+*
+* @param: str -- pointer to the string
+*         negative -- print a minus sign
+*         intPart -- integer part
+*         frac -- fraction part, scaled by 2^64
+*         decimals -- decimal places, up to DATA_FTOA_MAX_DECIMALS
+*
+* @return: pointer to the string
+*/
+static uint8_t * data_FixToa(uint8_t *str, bool negative, uint32_t intPart, uint64_t frac, uint8_t decimals){
+	uint8_t buf[DATA_ITOA_BUF_SIZE];
+	uint8_t * p;
+	uint8_t * out = str;
+	uint32_t len;
+	uint64_t hi, lo;
+
+	if(decimals > DATA_FTOA_MAX_DECIMALS)
+		decimals = DATA_FTOA_MAX_DECIMALS;
+	/* Round once up front, a carry out of the fraction bumps the integer */
+	if(frac + data_HalfUlp[decimals] < frac)
+		intPart++;
+	frac += data_HalfUlp[decimals];
+
+	if(negative && ((intPart != 0U) || (decimals != 0U)))
+		*out++ = '-';
+	p = data_Utoa10(buf + sizeof(buf), intPart);
+	len = (buf + sizeof(buf)) - p;
+	memcpy(out, p, len);
+	out += len;
+	if(decimals != 0U){
+		*out++ = '.';
+		/* Each digit is the integer part of the fraction times ten,
+		 * multiplied in 32-bit halves so no bit of it is lost */
+		while(decimals--){
+			lo = (frac & 0xFFFFFFFFU) * 10U;
+			hi = (frac >> 32) * 10U + (lo >> 32);
+			*out++ = (uint8_t)('0' + (uint32_t)(hi >> 32));
+			frac = (hi << 32) | (lo & 0xFFFFFFFFU);
+		}
+	}
+	*out = '\0';
+	return str;
+}
+
+uint8_t * my_itoa(uint8_t *str, int32_t data, int32_t base){
+	uint8_t buf[DATA_ITOA_BUF_SIZE];
+	uint8_t * p = buf + sizeof(buf);
+	uint32_t num, quot, shift;
+	bool negative = false;
+
+	if(str == NULL)
+		return NULL;
+	if((base < 2) || (base > 36)){
+		str[0] = '\0';
+		return str;
+	}
+	if((base == 10) && (data < 0)){
+		negative = true;
+		num = 0U - (uint32_t)data;
+	}
+	else{
+		num = (uint32_t)data;
+	}
+
+	if(base == 10){
+		p = data_Utoa10(p, num);
+		if(negative)
+			*--p = '-';
+	}
+	else if((base & (base - 1)) == 0){
+		/* Powers of two, negative values print as two's complement */
+		for(shift = 0; (1 << shift) != base; shift++);
+		do{
+			*--p = data_Digits[num & (uint32_t)(base - 1)];
+			num >>= shift;
+		}while(num);
+	}
+	else{
+		do{
+			quot = num / (uint32_t)base;
+			*--p = data_Digits[num - quot * (uint32_t)base];
+			num = quot;
+		}while(num);
+	}
+	memcpy(str, p, (buf + sizeof(buf)) - p);
+	str[(buf + sizeof(buf)) - p] = '\0';
+	return str;
+}
+
+int32_t my_atoi(uint8_t *str){
+	uint32_t num = 0;
+	uint32_t word;
+	bool negative = false;
+
+	if(str == NULL)
+		return 0;
+	while((*str == ' ') || ((uint8_t)(*str - '\t') <= ('\r' - '\t')))
+		str++;
+	if((*str == '-') || (*str == '+')){
+		negative = (*str == '-');
+		str++;
+	}
+	/* Single digits until the pointer is word aligned */
+	while((((uint32_t)str & 3U) != 0U) && ((uint8_t)(*str - '0') < 10U)){
+		num = num * 10U + (uint32_t)(*str++ - '0');
+	}
+	/* Four digits per aligned load. An aligned word never crosses into
+	 * unmapped memory, so reading past the terminator is harmless. */
+	if(((uint32_t)str & 3U) == 0U){
+		word = *(uint32_t *)str;
+		while(data_IsDigits4(word)){
+			num = num * 10000U + data_ParseDigits4(word);
+			str += 4;
+			word = *(uint32_t *)str;
+		}
+	}
+	while((uint8_t)(*str - '0') < 10U){
+		num = num * 10U + (uint32_t)(*str++ - '0');
+	}
+	return negative ? (int32_t)(0U - num) : (int32_t)num;
+}
+
+uint8_t * my_ftoa(uint8_t *str, float fdata){
+	return my_ftoa_n(str, fdata, DATA_FTOA_DECIMALS);
+}
+
+uint8_t * my_ftoa_n(uint8_t *str, float fdata, uint8_t decimals){
+	uint32_t bits, mant, intPart;
+	uint64_t frac;
+	int32_t exp, shift;
+	bool negative;
+
+	if(str == NULL)
+		return NULL;
+	/* Take the IEEE-754 fields apart instead of doing float math */
+	memcpy(&bits, &fdata, sizeof(bits));
+	negative = (bits >> 31) != 0U;
+	exp = (int32_t)((bits >> 23) & 0xFFU);
+	mant = bits & 0x007FFFFFU;
+	if(exp == 0xFF){
+		strcpy((char *)str, (mant != 0U) ? "nan" : (negative ? "-inf" : "inf"));
+		return str;
+	}
+	if(exp != 0)
+		mant |= 0x00800000U;				// Implicit leading one
+	else
+		exp = 1;							// Subnormal
+	/* value = mant * 2^(exp - 150) */
+	shift = 150 - exp;
+	if(shift <= 0){
+		if(shift < -8){
+			strcpy((char *)str, negative ? "-ovf" : "ovf");		// Integer part needs more than 32 bits
+			return str;
+		}
+		intPart = mant << -shift;
+		frac = 0U;
+	}
+	else{
+		/* Keep every fraction bit down to 2^-64 so rounding sees them */
+		intPart = (shift < 32) ? (mant >> shift) : 0U;
+		if(shift < 64)
+			frac = (uint64_t)mant << (64 - shift);
+		else
+			frac = (shift - 64 < 24) ? (mant >> (shift - 64)) : 0U;
+	}
+	return data_FixToa(str, negative, intPart, frac, decimals);
+}
+
+uint8_t * my_q16toa(uint8_t *str, int32_t q16, uint8_t decimals){
+	uint32_t num;
+
+	if(str == NULL)
+		return NULL;
+	num = (q16 < 0) ? (0U - (uint32_t)q16) : (uint32_t)q16;
+	return data_FixToa(str, q16 < 0, num >> 16, (uint64_t)(num & 0xFFFFU) << 48, decimals);
+}
+
+uint32_t my_crc32(const uint8_t *data, uint32_t length){
+	uint32_t crc = 0xFFFFFFFFU;
+
+	if(data == NULL)
+		return 0;
+	while(length--){
+		crc ^= *data++;
+		crc = (crc >> 4) ^ data_Crc32Nibble[crc & 0x0FU];
+		crc = (crc >> 4) ^ data_Crc32Nibble[crc & 0x0FU];
+	}
+	return ~crc;
+}
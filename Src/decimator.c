@@ -0,0 +1,153 @@
+/***************************************************************************
+ *
+ *	Filename: 		decimator.c
+ *  Description:  	ADC oversampling and decimation filter implementation
+ *
+ *****************************************************************************/
+
+#include "includes.h"
+
+dec_status_t dec_Init(decimator_t *dec, uint32_t ratio, uint8_t stages, uint8_t inBits, uint8_t outBits){
+	uint32_t log2Ratio = 0;
+	uint32_t growth;
+
+	if((dec == NULL) || (ratio < 2U) || ((ratio & (ratio - 1U)) != 0U) ||
+	   (stages == 0) || (stages > DEC_MAX_STAGES) || (inBits == 0) || (outBits == 0))
+		return status_DEC_InvalidArgument;
+	while((1U << log2Ratio) != ratio)
+		log2Ratio++;
+	growth = inBits + stages * log2Ratio;
+	if((growth > DEC_MAX_BITS) || (outBits > growth))
+		return status_DEC_InvalidArgument;
+	dec->ratio = ratio;
+	dec->stages = stages;
+	dec->outShift = (uint8_t)(growth - outBits);
+	dec_Reset(dec);
+	return status_DEC_Success;
+}
+
+void dec_Reset(decimator_t *dec){
+	uint32_t i;
+
+	for(i = 0; i < DEC_MAX_STAGES; i++){
+		dec->integ[i] = 0;
+		dec->comb[i] = 0;
+	}
+	dec->phase = 0;
+}
+
+/****************************************************
+* @name: dec_Boxcar
+*
+* @description: order 1: sum ratio samples, four per step
+*/
+static uint32_t dec_Boxcar(decimator_t *dec, const uint16_t *in, uint32_t stride, uint32_t count, uint32_t *out){
+	uint32_t acc = dec->integ[0];
+	uint32_t phase = dec->phase;
+	uint32_t outCnt = 0;
+	uint32_t n;
+
+	while(count){
+		n = dec->ratio - phase;
+		if(n > count)
+			n = count;
+		phase += n;
+		count -= n;
+		for(; n >= 4U; n -= 4U){
+			acc += (uint32_t)in[0] + in[stride] + in[2U * stride] + in[3U * stride];
+			in += 4U * stride;
+		}
+		while(n--){
+			acc += *in;
+			in += stride;
+		}
+		if(phase == dec->ratio){
+			out[outCnt++] = acc >> dec->outShift;
+			acc = 0;
+			phase = 0;
+		}
+	}
+	dec->integ[0] = acc;
+	dec->phase = phase;
+	return outCnt;
+}
+
+/****************************************************
+* @name: dec_Comb
+*
+* @description: run the comb stages on an integrator output
+*/
+static uint32_t dec_Comb(decimator_t *dec, uint32_t y){
+	uint32_t i, prev;
+
+	for(i = 0; i < dec->stages; i++){
+		prev = dec->comb[i];
+		dec->comb[i] = y;
+		y -= prev;
+	}
+	return y >> dec->outShift;
+}
+
+/****************************************************
+* @name: dec_Cic
+*
+* @description: order 2 and 3: integrators at the input rate with
+*               the state kept in locals, combs at the output rate
+*/
+static uint32_t dec_Cic(decimator_t *dec, const uint16_t *in, uint32_t stride, uint32_t count, uint32_t *out){
+	uint32_t i0 = dec->integ[0];
+	uint32_t i1 = dec->integ[1];
+	uint32_t i2 = dec->integ[2];
+	uint32_t phase = dec->phase;
+	uint32_t outCnt = 0;
+	uint32_t n;
+
+	while(count){
+		n = dec->ratio - phase;
+		if(n > count)
+			n = count;
+		phase += n;
+		count -= n;
+		if(dec->stages == 2U){
+			for(; n >= 2U; n -= 2U){
+				i0 += in[0];		i1 += i0;
+				i0 += in[stride];	i1 += i0;
+				in += 2U * stride;
+			}
+			if(n){
+				i0 += *in;			i1 += i0;
+				in += stride;
+			}
+			if(phase == dec->ratio)
+				out[outCnt++] = dec_Comb(dec, i1);
+		}
+		else{
+			for(; n >= 2U; n -= 2U){
+				i0 += in[0];		i1 += i0;	i2 += i1;
+				i0 += in[stride];	i1 += i0;	i2 += i1;
+				in += 2U * stride;
+			}
+			if(n){
+				i0 += *in;			i1 += i0;	i2 += i1;
+				in += stride;
+			}
+			if(phase == dec->ratio)
+				out[outCnt++] = dec_Comb(dec, i2);
+		}
+		if(phase == dec->ratio)
+			phase = 0;
+	}
+	dec->integ[0] = i0;
+	dec->integ[1] = i1;
+	dec->integ[2] = i2;
+	dec->phase = phase;
+	return outCnt;
+}
+
+uint32_t dec_Process(decimator_t *dec, const uint16_t *in, uint32_t stride, uint32_t count, uint32_t *out){
+	if((dec == NULL) || (in == NULL) || (out == NULL) || (stride == 0))
+		return 0;
+	if(dec->stages == 1U)
+		return dec_Boxcar(dec, in, stride, count, out);
+	return dec_Cic(dec, in, stride, count, out);
+}
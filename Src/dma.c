@@ -1,5 +1,10 @@
 #include "includes.h"
 
+static dma_callback_t dma_Callback[DMA_CHANNEL_CNT] = {NULL};
+static dma_job_t * volatile dma_Job[DMA_CHANNEL_CNT] = {NULL};
+static volatile uint8_t dma_ChannelUsed = 0U;				// Bit n set when channel n is allocated
+static uint32_t dma_PatternWord[DMA_CHANNEL_CNT];			// Fill source of each channel's memset job
+
 uint8_t dma_Init_Mem2mem(uint8_t dma_ch, 
 						 uint8_t * source_addr,
 						 uint8_t * destination_addr,
@@ -17,8 +22,8 @@ uint8_t dma_Init_Mem2mem(uint8_t dma_ch,
 
 #if DMA_ISR_ENABLE
 	DMA_DCR_REG(DMA_BASE_PTR, dma_ch) |= DMA_DCR_EINT_MASK;					// Enable DMA interrupt
-	NVIC_EnableIRQ(DMA0_IRQn);
-	NVIC_SetPriority(DMA0_IRQn,2); 
+	NVIC_EnableIRQ((IRQn_Type)(DMA0_IRQn + dma_ch));
+	NVIC_SetPriority((IRQn_Type)(DMA0_IRQn + dma_ch),2); 
 #endif
 	
 	if (DMA_DSR_BCR_REG(DMA_BASE_PTR, dma_ch) & DMA_DSR_BCR_CE_MASK){		// Check for configuration error
@@ -49,6 +54,8 @@ uint8_t dma_Init_Mem2Per(uint8_t dma_ch,
 										DMA_DCR_DSIZE(1);					// setting destination size (0:32bit/1:8bit/2:16bit
 #if DMA_ISR_ENABLE
 	DMA_DCR_REG(DMA_BASE_PTR, dma_ch) |= DMA_DCR_EINT_MASK;					// Enable DMA interrupt
+	NVIC_EnableIRQ((IRQn_Type)(DMA0_IRQn + dma_ch));
+	NVIC_SetPriority((IRQn_Type)(DMA0_IRQn + dma_ch),2); 
 #endif
 	DMAMUX0_CHCFG(dma_ch) = DMAMUX_CHCFG_SOURCE(per_source);				// Selecting DMA request peripheral source
 	
@@ -81,6 +88,8 @@ uint8_t dma_Init_Per2Mem(uint8_t dma_ch,
 										DMA_DCR_DSIZE(1);					// setting destination size (0:32bit/1:8bit/2:16bit
 #if DMA_ISR_ENABLE
 	DMA_DCR_REG(DMA_BASE_PTR, dma_ch) |= DMA_DCR_EINT_MASK;					// Enable DMA interrupt
+	NVIC_EnableIRQ((IRQn_Type)(DMA0_IRQn + dma_ch));
+	NVIC_SetPriority((IRQn_Type)(DMA0_IRQn + dma_ch),2); 
 #endif
 	DMAMUX0_CHCFG(dma_ch) = DMAMUX_CHCFG_SOURCE(per_source);				// Selecting DMA request peripheral source
 	
@@ -93,3 +102,230 @@ uint8_t dma_Init_Per2Mem(uint8_t dma_ch,
 	}
 }
 
+void dma_SetCallback(uint8_t dma_ch, dma_callback_t callback)
+{
+	assert(dma_ch < DMA_CHANNEL_CNT);
+	dma_Callback[dma_ch] = callback;
+}
+
+uint8_t dma_ChannelAlloc(void)
+{
+	uint8_t dma_ch;
+	uint32_t primask = SYS_SaveDisableIRQ();
+	for(dma_ch = 0; dma_ch < DMA_CHANNEL_CNT; dma_ch++)
+	{
+		if(!(dma_ChannelUsed & (1U << dma_ch)))
+		{
+			dma_ChannelUsed |= (1U << dma_ch);
+			SYS_RestoreIRQ(primask);
+			return dma_ch;
+		}
+	}
+	SYS_RestoreIRQ(primask);
+	return DMA_CHANNEL_NONE;
+}
+
+void dma_ChannelFree(uint8_t dma_ch)
+{
+	uint32_t primask;
+	assert(dma_ch < DMA_CHANNEL_CNT);
+	primask = SYS_SaveDisableIRQ();
+	dma_ChannelUsed &= ~(1U << dma_ch);
+	SYS_RestoreIRQ(primask);
+}
+
+/* Program and start one memory block on an allocated channel. A NULL
+ * src fills dst with value, read from the channel's static pattern word. */
+static dma_status_t dma_StartBlock(uint8_t dma_ch,
+								   uint8_t * dst,
+								   const uint8_t * src,
+								   uint8_t value,
+								   uint32_t length)
+{
+	if(!src)
+	{
+		dma_PatternWord[dma_ch] = value * 0x01010101U;
+	}
+	if(dma_Init_Mem2mem(dma_ch, src ? (uint8_t *)src : (uint8_t *)&dma_PatternWord[dma_ch], dst, length))
+	{
+		return status_DMA_Error;
+	}
+	if(!src)
+	{
+		DMA_DCR_REG(DMA_BASE_PTR, dma_ch) &= ~DMA_DCR_SINC_MASK;			// Keep reading the pattern word
+	}
+	if(((((uint32_t)dst | length | (uint32_t)src) & 3U) == 0U))
+	{
+		DMA_DCR_REG(DMA_BASE_PTR, dma_ch) &= ~(DMA_DCR_SSIZE_MASK |			// 32-bit transfers when everything is word aligned
+											   DMA_DCR_DSIZE_MASK);
+	}
+	DMA_DCR_REG(DMA_BASE_PTR, dma_ch) |= DMA_DCR_START_MASK;				// Start the transfer
+	return status_DMA_Success;
+}
+
+/* Claim a channel for job and start its first block on it */
+static dma_status_t dma_StartJob(dma_job_t *job,
+								 uint8_t * dst,
+								 const uint8_t * src,
+								 uint8_t value,
+								 uint32_t length,
+								 dma_job_callback_t callback,
+								 void *usrData)
+{
+	uint8_t dma_ch;
+	
+	if((!job) || (!dst) || (length == 0) || (length > DMA_DSR_BCR_BCR_MASK))
+	{
+		return status_DMA_InvalidArgument;
+	}
+	dma_ch = dma_ChannelAlloc();
+	if(dma_ch == DMA_CHANNEL_NONE)
+	{
+		return status_DMA_Busy;
+	}
+	job->dma_ch = dma_ch;
+	job->callback = callback;
+	job->usrData = usrData;
+	job->state = dmaJobBusy;
+	dma_Job[dma_ch] = job;
+	
+	if(dma_StartBlock(dma_ch, dst, src, value, length) != status_DMA_Success)
+	{
+		dma_Job[dma_ch] = NULL;
+		job->state = dmaJobError;
+		dma_ChannelFree(dma_ch);
+		return status_DMA_Error;
+	}
+	return status_DMA_Success;
+}
+
+dma_status_t dma_MemcpyAsync(dma_job_t *job,
+							 uint8_t * dst,
+							 const uint8_t * src,
+							 uint32_t length,
+							 dma_job_callback_t callback,
+							 void *usrData)
+{
+	if(!src)
+	{
+		return status_DMA_InvalidArgument;
+	}
+	if(job)
+	{
+		job->segList = NULL;
+	}
+	return dma_StartJob(job, dst, src, 0U, length, callback, usrData);
+}
+
+dma_status_t dma_MemsetAsync(dma_job_t *job,
+							 uint8_t * dst,
+							 uint8_t value,
+							 uint32_t length,
+							 dma_job_callback_t callback,
+							 void *usrData)
+{
+	if(job)
+	{
+		job->segList = NULL;
+	}
+	return dma_StartJob(job, dst, NULL, value, length, callback, usrData);
+}
+
+dma_status_t dma_ScatterGatherAsync(dma_job_t *job,
+									const dma_sg_desc_t *list,
+									uint32_t count,
+									dma_job_callback_t callback,
+									void *usrData)
+{
+	uint32_t i;
+	
+	if((!job) || (!list) || (count == 0))
+	{
+		return status_DMA_InvalidArgument;
+	}
+	/* Check every segment up front so the ISR never meets a bad one */
+	for(i = 0; i < count; i++)
+	{
+		if((!list[i].src) || (!list[i].dst) || (list[i].length == 0) || (list[i].length > DMA_DSR_BCR_BCR_MASK))
+		{
+			return status_DMA_InvalidArgument;
+		}
+	}
+	job->segList = list;
+	job->segCount = count;
+	job->segIndex = 0;
+	return dma_StartJob(job, list[0].dst, list[0].src, 0U, list[0].length, callback, usrData);
+}
+
+dma_status_t dma_Wait(dma_job_t *job, uint32_t timeout)
+{
+	uint32_t timeStart;
+	
+	if(!job)
+	{
+		return status_DMA_InvalidArgument;
+	}
+	timeStart = SYS_TimeGetMsec();
+	while(job->state == dmaJobBusy)
+	{
+		if((timeout != SYS_WAIT_FOREVER) && (SYS_TimeDiff(timeStart, SYS_TimeGetMsec()) > timeout))
+		{
+			return status_DMA_Timeout;
+		}
+	}
+	return (job->state == dmaJobDone) ? status_DMA_Success : status_DMA_Error;
+}
+
+static void dma_IRQHandler(uint8_t dma_ch)
+{
+	dma_job_t *job = dma_Job[dma_ch];
+	uint32_t status = DMA_DSR_BCR_REG(DMA_BASE_PTR, dma_ch);
+	
+	DMA_DSR_BCR_REG(DMA_BASE_PTR, dma_ch) |= DMA_DSR_BCR_DONE_MASK;			// Clear DONE bit and the interrupt
+	if(job)
+	{
+		bool failed = (status & (DMA_DSR_BCR_CE_MASK | DMA_DSR_BCR_BES_MASK | DMA_DSR_BCR_BED_MASK)) != 0U;
+		
+		/* Launch the next scatter/gather segment on the same channel */
+		if((!failed) && (job->segList) && (job->segIndex + 1U < job->segCount))
+		{
+			const dma_sg_desc_t *seg = &job->segList[++job->segIndex];
+			if(dma_StartBlock(dma_ch, seg->dst, seg->src, 0U, seg->length) == status_DMA_Success)
+			{
+				return;
+			}
+			failed = true;
+		}
+		dma_Job[dma_ch] = NULL;
+		dma_ChannelFree(dma_ch);
+		job->state = failed ? dmaJobError : dmaJobDone;
+		if(job->callback)
+		{
+			job->callback(job);
+		}
+	}
+	else if(dma_Callback[dma_ch])
+	{
+		dma_Callback[dma_ch](dma_ch);
+	}
+}
+
+void DMA0_IRQHandler(void)
+{
+	dma_IRQHandler(0U);
+}
+
+void DMA1_IRQHandler(void)
+{
+	dma_IRQHandler(1U);
+}
+
+void DMA2_IRQHandler(void)
+{
+	dma_IRQHandler(2U);
+}
+
+void DMA3_IRQHandler(void)
+{
+	dma_IRQHandler(3U);
+}
@@ -0,0 +1,181 @@
+/***************************************************************************
+ *
+ *	Filename: 		flash.c
+ *  Description:  	program flash (FTFA) driver implementation
+ *
+ *****************************************************************************/
+
+#include "includes.h"
+
+#if FLASH_RAM_STANDIN
+
+static uint32_t flashStandIn[FLASH_STANDIN_SECTORS * FLASH_SECTOR_SIZE / 4U];
+
+/* Word index of addr in the stand-in, or -1 if the range is outside it */
+static int32_t flash_StandInIndex(uint32_t addr, uint32_t length)
+{
+	if((addr < FLASH_STANDIN_BASE) || (length > sizeof(flashStandIn)) ||
+	   (addr - FLASH_STANDIN_BASE > sizeof(flashStandIn) - length))
+	{
+		return -1;
+	}
+	return (int32_t)((addr - FLASH_STANDIN_BASE) >> 2);
+}
+
+flash_status_t flash_EraseSector(uint32_t addr)
+{
+	int32_t idx = flash_StandInIndex(addr, FLASH_SECTOR_SIZE);
+	uint32_t i;
+
+	if((idx < 0) || (addr & (FLASH_SECTOR_SIZE - 1U)))
+	{
+		return status_FLASH_InvalidArgument;
+	}
+	for(i = 0; i < FLASH_SECTOR_SIZE / 4U; i++)
+	{
+		flashStandIn[idx + i] = FLASH_ERASED_WORD;
+	}
+	return status_FLASH_Success;
+}
+
+flash_status_t flash_Program(uint32_t addr, const uint32_t *data, uint32_t words)
+{
+	int32_t idx = flash_StandInIndex(addr, words * 4U);
+	uint32_t i;
+
+	if((idx < 0) || (!data) || (addr & 3U))
+	{
+		return status_FLASH_InvalidArgument;
+	}
+	for(i = 0; i < words; i++)
+	{
+		/* Like the real flash, a word can only be programmed once per erase */
+		if(flashStandIn[idx + i] != FLASH_ERASED_WORD)
+		{
+			return status_FLASH_VerifyError;
+		}
+		flashStandIn[idx + i] = data[i];
+	}
+	return status_FLASH_Success;
+}
+
+flash_status_t flash_Read(uint32_t addr, void *data, uint32_t length)
+{
+	int32_t idx = flash_StandInIndex(addr, length);
+
+	if((idx < 0) || (!data))
+	{
+		return status_FLASH_InvalidArgument;
+	}
+	memcpy(data, (uint8_t *)flashStandIn + (addr - FLASH_STANDIN_BASE), length);
+	return status_FLASH_Success;
+}
+
+#else
+
+#define FLASH_CMD_PROGRAM_LONGWORD	(0x06U)
+#define FLASH_CMD_ERASE_SECTOR		(0x09U)
+
+/* Code in a .data input section is linked to a RAM address and copied
+ * there from flash by the startup code, along with the initialized data.
+ * RAM is out of BL range of the flash, so callers need a long call. */
+#define FLASH_RAMFUNC				__attribute__((section(".data.ramfunc"), noinline, long_call))
+
+/****************************************************
+* @name: flash_LaunchAndWait
+*
+* @description: start the command loaded in FCCOB and wait for it.
+*               It runs from RAM because the flash can't be fetched
+*               from while it executes a command. Nothing here may
+*               call into flash.
+*/
+static FLASH_RAMFUNC void flash_LaunchAndWait(void)
+{
+	FTFA_FSTAT = FTFA_FSTAT_CCIF_MASK;
+	while(!(FTFA_FSTAT & FTFA_FSTAT_CCIF_MASK))
+	{}
+}
+
+static flash_status_t flash_RunCommand(void)
+{
+	uint32_t primask;
+	uint8_t fstat;
+
+	while(!(FTFA_FSTAT & FTFA_FSTAT_CCIF_MASK))
+	{}
+	FTFA_FSTAT = FTFA_FSTAT_ACCERR_MASK | FTFA_FSTAT_FPVIOL_MASK;		// Clear the last errors
+
+	/* Vectors and ISRs live in flash too */
+	primask = SYS_SaveDisableIRQ();
+	flash_LaunchAndWait();
+	SYS_RestoreIRQ(primask);
+
+	fstat = FTFA_FSTAT;
+	if(fstat & (FTFA_FSTAT_ACCERR_MASK | FTFA_FSTAT_FPVIOL_MASK))
+	{
+		return status_FLASH_AccessError;
+	}
+	if(fstat & FTFA_FSTAT_MGSTAT0_MASK)
+	{
+		return status_FLASH_VerifyError;
+	}
+	return status_FLASH_Success;
+}
+
+static void flash_SetAddress(uint32_t addr)
+{
+	FTFA_FCCOB1 = (uint8_t)(addr >> 16);
+	FTFA_FCCOB2 = (uint8_t)(addr >> 8);
+	FTFA_FCCOB3 = (uint8_t)addr;
+}
+
+flash_status_t flash_EraseSector(uint32_t addr)
+{
+	if(addr & (FLASH_SECTOR_SIZE - 1U))
+	{
+		return status_FLASH_InvalidArgument;
+	}
+	FTFA_FCCOB0 = FLASH_CMD_ERASE_SECTOR;
+	flash_SetAddress(addr);
+	return flash_RunCommand();
+}
+
+flash_status_t flash_Program(uint32_t addr, const uint32_t *data, uint32_t words)
+{
+	flash_status_t status;
+
+	if((!data) || (addr & 3U))
+	{
+		return status_FLASH_InvalidArgument;
+	}
+	while(words--)
+	{
+		FTFA_FCCOB0 = FLASH_CMD_PROGRAM_LONGWORD;
+		flash_SetAddress(addr);
+		/* FCCOB4 takes the most significant byte */
+		FTFA_FCCOB4 = (uint8_t)(*data >> 24);
+		FTFA_FCCOB5 = (uint8_t)(*data >> 16);
+		FTFA_FCCOB6 = (uint8_t)(*data >> 8);
+		FTFA_FCCOB7 = (uint8_t)*data;
+		status = flash_RunCommand();
+		if(status != status_FLASH_Success)
+		{
+			return status;
+		}
+		addr += 4U;
+		data++;
+	}
+	return status_FLASH_Success;
+}
+
+flash_status_t flash_Read(uint32_t addr, void *data, uint32_t length)
+{
+	if(!data)
+	{
+		return status_FLASH_InvalidArgument;
+	}
+	memcpy(data, (const void *)addr, length);		// Program flash is memory mapped
+	return status_FLASH_Success;
+}
+
+#endif /* FLASH_RAM_STANDIN */
@@ -12,13 +12,170 @@
 extern CircBuf_t * tx_buf; 
 extern CircBuf_t * rx_buf;
 
+static uint32_t lastEvtTime = 0;
+
+/****************************************************
+* @name: log_PutVarint
+*
+* @description: Encode a value as a varint
+*               
+* @param: dst -- pointer to the output buffer
+* 		  value -- value to encode
+*
+* @return: number of bytes written, 1 to 5
+*/
+static uint8_t log_PutVarint(uint8_t * dst, uint32_t value){
+	uint8_t n = 0;
+	while(value >= 0x80U){
+		dst[n++] = (uint8_t)(value | 0x80U);
+		value >>= 7;
+	}
+	dst[n++] = (uint8_t)value;
+	return n;
+}
+
+/****************************************************
+* @name: log_PutHeader
+*
+* @description: Encode the header byte and the delta timestamp
+*               of a record
+*               
+* @param: dst -- pointer to the output buffer
+* 		  header -- argument count and event ID
+* 		  now -- time of the record in ms
+*
+* @return: number of bytes written, 2 to 6
+*/
+static uint8_t log_PutHeader(uint8_t * dst, uint8_t header, uint32_t now){
+	dst[0] = header;
+	return 1U + log_PutVarint(&dst[1], SYS_TimeDiff(lastEvtTime, now));
+}
+
 #ifndef DEBUG
 void log_Str(uint8_t *str){} 
 void log_Mem(uint8_t * source, uint32_t num){}
 void log_Int(uint8_t * str, int32_t data){}
 void log_Float(uint8_t * str, float fdata){}
+void log_Q16(uint8_t * str, int32_t q16){}
+bool log_Process(void){ return false; }
+
+#elif defined(_BBB)
+/****************************************************
+* On the BBB the logs go straight to printf
+*/
+void log_Str(uint8_t *str){
+	printf("%s", str);
+}
+
+void log_Mem(uint8_t * source, uint32_t num){
+	while (num>0){
+		printf("%c",*source++);
+		num--;
+	}
+}
+
+void log_Int(uint8_t * str, int32_t data){
+	printf("%s%d", str, data);
+}
+
+void log_Float(uint8_t * str, float fdata){
+	printf("%s%f",str, fdata);
+}
+
+void log_Q16(uint8_t * str, int32_t q16){
+	uint8_t temp[32];
+	printf("%s%s", str, my_q16toa(temp, q16, LOG_Q16_DECIMALS));
+}
+
+bool log_Process(void){
+	return false;
+}
 
 #else
+/****************************************************
+* Deferred log records
+*
+* log_Str/log_Int/log_Float/log_Q16 only store the string pointer and
+* the raw argument word here. log_Process formats them into
+* the TX buffer later, from the idle loop, as LOG_EVT_TEXT frames.
+*/
+typedef enum log_arg_type
+{
+	logArgNone = 0U,
+	logArgInt,
+	logArgFloat,
+	logArgQ16
+}log_arg_type_t;
+
+/****************************************************
+* @name: log_PutFrame
+*
+* @description: Enqueue a LOG_EVT_TEXT or LOG_EVT_MEM frame made of
+*               two byte runs, cut to LOG_FRAME_MAX_LEN bytes
+*               
+* @param: evtId -- LOG_EVT_TEXT or LOG_EVT_MEM
+* 		  part1, len1 -- first run of the payload
+* 		  part2, len2 -- second run of the payload
+*
+* @return: false if the TX buffer has no room for the whole frame
+*/
+static bool log_PutFrame(uint8_t evtId, const uint8_t * part1, uint32_t len1,
+						 const uint8_t * part2, uint32_t len2){
+	uint8_t head[1 + 5 + 1];
+	uint8_t n;
+	uint32_t now;
+	
+	if(len1 > LOG_FRAME_MAX_LEN)
+		len1 = LOG_FRAME_MAX_LEN;
+	if(len2 > LOG_FRAME_MAX_LEN - len1)
+		len2 = LOG_FRAME_MAX_LEN - len1;
+	now = SYS_TimeGetMsec();
+	n = log_PutHeader(head, evtId, now);
+	n += log_PutVarint(&head[n], len1 + len2);
+	
+	/* A partial frame would desynchronize the decoder */
+	if((tx_buf->size - cb_Length(tx_buf)) < n + len1 + len2)
+		return false;
+	lastEvtTime = now;
+	cb_EnqueueBulk(tx_buf, head, n);
+	cb_EnqueueBulk(tx_buf, part1, len1);
+	cb_EnqueueBulk(tx_buf, part2, len2);
+	uart0_TxStart();
+	return true;
+}
+
+typedef struct log_record
+{
+	const uint8_t * str;	// string with static storage, not copied
+	uint32_t arg;			// raw int32_t, Q16.16 or float bits
+	log_arg_type_t type;
+}log_record_t;
+
+static log_record_t logRecord[LOG_RECORD_CNT];
+static volatile uint32_t logHead = 0;		// next record to format, owned by log_Process
+static volatile uint32_t logTail = 0;		// next free record, owned by the loggers
+volatile uint32_t logDropped = 0;			// records lost because the ring was full
+
+static void log_PutRecord(const uint8_t * str, uint32_t arg, log_arg_type_t type){
+	uint32_t primask;
+	log_record_t * rec;
+	
+	/* Loggers may run in the main loop and in ISRs, so claim the slot atomically */
+	primask = SYS_SaveDisableIRQ();
+	if((logTail - logHead) == LOG_RECORD_CNT){
+		logDropped++;
+		SYS_RestoreIRQ(primask);
+		return;
+	}
+	rec = &logRecord[logTail & (LOG_RECORD_CNT - 1U)];
+	rec->str = str;
+	rec->arg = arg;
+	rec->type = type;
+	SYS_MemoryBarrier();
+	logTail++;
+	SYS_RestoreIRQ(primask);
+}
+
 /****************************************************
 * @name: log_Str
 *
@@ -27,15 +184,8 @@ void log_Float(uint8_t * str, float fdata){}
 * @param: src -- pointer to the string to be logged
 *
 */	
- void log_Str(uint8_t *str){
-#ifdef _BBB
-	printf("%s", str);
-#else
-	while(*str != '\0')
-			cb_Enqueue(tx_buf, *str++);
-	if((cb_IsEmpty(tx_buf)!=EMPTY)&&(!(UART0_C2 & UART0_C2_TIE_MASK)))
-		UART0_C2 |= UART0_C2_TIE_MASK;
-#endif
+void log_Str(uint8_t *str){
+	log_PutRecord(str, 0, logArgNone);
 }
 
 /****************************************************
@@ -48,21 +198,15 @@ void log_Float(uint8_t * str, float fdata){}
 *
 */
 void log_Mem(uint8_t * source, uint32_t num){
-
-#ifdef _BBB
-	while (num>0){
-		printf("%c",*source++);
-		num--;
-	}
-#else
-	while(num>0){
-		cb_Enqueue(tx_buf, *source++);
-		num--;
+	uint32_t len;
+	
+	/* One frame per LOG_FRAME_MAX_LEN bytes; a frame that doesn't fit is dropped */
+	while(num > 0){
+		len = (num > LOG_FRAME_MAX_LEN) ? LOG_FRAME_MAX_LEN : num;
+		log_PutFrame(LOG_EVT_MEM, source, len, NULL, 0);
+		source += len;
+		num -= len;
 	}
-	if((cb_IsEmpty(tx_buf)!=EMPTY)&&(!(UART0_C2 & UART0_C2_TIE_MASK)))
-		UART0_C2 |= UART0_C2_TIE_MASK;
-#endif
-		
 }
 
 /****************************************************
@@ -75,16 +219,7 @@ void log_Mem(uint8_t * source, uint32_t num){
 *
 */
 void log_Int(uint8_t * str, int32_t data){
-		
-#ifdef _BBB
-	printf("%s%d", str, data);
-#else
-	uint8_t temp[12];
-	my_itoa(temp, data, 10);
-	log_Str(str);
-	log_Str(temp);
-#endif		
-	
+	log_PutRecord(str, (uint32_t)data, logArgInt);
 }
 
 /****************************************************
@@ -97,15 +232,95 @@ void log_Int(uint8_t * str, int32_t data){
 *
 */
 void log_Float(uint8_t * str, float fdata){
+	uint32_t bits;
+	memcpy(&bits, &fdata, sizeof(bits));
+	log_PutRecord(str, bits, logArgFloat);
+}
 
-#ifdef _BBB
-	printf("%s%f",str, fdata);
-#else
-	uint8_t temp[32];	
-	my_ftoa(temp, fdata);
-	log_Str(str);
-	log_Str(temp);
-#endif
+/****************************************************
+* @name: log_Q16
+*
+* @description: Log a string with a Q16.16 fixed-point value
+*               
+* @param: str -- pointer to the string to be logged
+* 		  q16 -- value scaled by 65536
+*
+*/
+void log_Q16(uint8_t * str, int32_t q16){
+	log_PutRecord(str, (uint32_t)q16, logArgQ16);
+}
+
+/****************************************************
+* @name: log_Process
+*
+* @description: Format pending log records into the TX buffer
+*               
+* @return: true if records are still pending because the
+*          TX buffer is full
+*/
+bool log_Process(void){
+	log_record_t * rec;
+	uint8_t temp[32];
+	uint32_t strLen, argLen;
+	float fdata;
+	
+	while(logHead != logTail){
+		SYS_MemoryBarrier();
+		rec = &logRecord[logHead & (LOG_RECORD_CNT - 1U)];
+		temp[0] = '\0';
+		if(rec->type == logArgInt){
+			my_itoa(temp, (int32_t)rec->arg, 10);
+		}
+		else if(rec->type == logArgFloat){
+			memcpy(&fdata, &rec->arg, sizeof(fdata));
+			my_ftoa(temp, fdata);
+		}
+		else if(rec->type == logArgQ16){
+			my_q16toa(temp, (int32_t)rec->arg, LOG_Q16_DECIMALS);
+		}
+		strLen = strlen((const char *)rec->str);
+		argLen = strlen((const char *)temp);
+		
+		/* Wait for the UART to make room; a frame always fits an empty buffer */
+		if(!log_PutFrame(LOG_EVT_TEXT, rec->str, strLen, temp, argLen)){
+			return true;
+		}
+		
+		SYS_MemoryBarrier();
+		logHead++;
+	}
+	return false;
 }
 
 #endif
+
+void log_EventArgs(uint8_t evtId, const int32_t * args, uint8_t argc){
+	uint8_t record[1 + 5 * (1 + LOG_EVT_MAX_ARGS)];
+	uint8_t n;
+	uint8_t i;
+	uint32_t now;
+	
+	assert(argc <= LOG_EVT_MAX_ARGS);
+	assert(evtId < LOG_EVT_MEM);
+	now = SYS_TimeGetMsec();
+	n = log_PutHeader(record, (uint8_t)((argc << LOG_EVT_ARGC_SHIFT) | (evtId & LOG_EVT_ID_MASK)), now);
+	for(i = 0; i < argc; i++){
+		/* Zigzag: 0,-1,1,-2,... -> 0,1,2,3,... */
+		n += log_PutVarint(&record[n], ((uint32_t)args[i] << 1) ^ (uint32_t)(args[i] >> 31));
+	}
+	
+	/* A partial record would desynchronize the decoder */
+	if((tx_buf->size - cb_Length(tx_buf)) < n)
+		return;
+	lastEvtTime = now;
+	cb_EnqueueBulk(tx_buf, record, n);
+	uart0_TxStart();
+}
+
+void log_Event(uint8_t evtId){
+	log_EventArgs(evtId, NULL, 0);
+}
+
+void log_Event1(uint8_t evtId, int32_t arg){
+	log_EventArgs(evtId, &arg, 1);
+}
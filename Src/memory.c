@@ -48,52 +48,111 @@ int8_t my_memmove(uint8_t * src, uint8_t * dst, int32_t length){
     return SUCCESS;
 }
 
+/****************************************************
+* @name: my_memmove_word
+*
+* @description: copy data from one memory to the other a word at a time.
+*               The destination is aligned first. If the source is then
+*               aligned too, 16 bytes are moved per iteration (four loads
+*               before four stores, which the compiler turns into LDM/STM);
+*               otherwise aligned source words are shifted and merged so
+*               no unaligned word access is ever made.
+*               
+* @param: src -- pointer to the source address
+*         dst -- pointer to the destination address
+*         length -- lenth of memory bytes to copy
+*
+* @return:SUCCESS/ERROR 
+*/
 int8_t my_memmove_word(uint8_t * src, uint8_t * dst, int32_t length){
-    uint32_t i;
-	uint32_t word_length;
-	uint32_t byte_length;
-    uint32_t * psrc; 	
-    uint32_t * pdst;
-	
+	uint32_t * psrc;
+	uint32_t * pdst;
+	uint32_t w0, w1, w2, w3;
+	uint32_t n = (uint32_t)length;
+	uint32_t shr, shl;
+
 	if (length == 0)
-        return ERROR;
-    if((NULL==src)||(NULL==dst))
 		return ERROR;
-	
-	word_length = length >> 2;
-	byte_length = length % 4;
-	
-    if ((dst <= src) || (dst > (src+length))){ //forward copy
-		psrc = (uint32_t *) src;
+	if((NULL==src)||(NULL==dst))
+		return ERROR;
+	if(n < MEM_WORD_COPY_MIN)
+		return my_memmove(src, dst, length);
+
+	if ((dst <= src) || (dst >= (src+length))){ //forward copy
+		/* Byte copy until the destination is word aligned */
+		while(((uint32_t)dst & 3U) != 0U){
+			*dst++ = *src++;
+			n--;
+		}
 		pdst = (uint32_t *) dst;
-		for (i=0;i<word_length;i++){
-			*pdst = *psrc;
-			pdst++;
-			psrc++;
+		if(((uint32_t)src & 3U) == 0U){
+			psrc = (uint32_t *) src;
+			for(; n >= 16U; n -= 16U){
+				w0 = psrc[0]; w1 = psrc[1]; w2 = psrc[2]; w3 = psrc[3];
+				pdst[0] = w0; pdst[1] = w1; pdst[2] = w2; pdst[3] = w3;
+				psrc += 4;
+				pdst += 4;
+			}
+			for(; n >= 4U; n -= 4U)
+				*pdst++ = *psrc++;
 		}
-		for (i=0;i<byte_length;i++){
-			*(uint8_t *)pdst = *(uint8_t *) psrc;
-			((uint8_t *)pdst)++;
-			((uint8_t *)psrc)++;
+		else{
+			/* Merge two aligned source words into each destination word */
+			shr = ((uint32_t)src & 3U) << 3;
+			shl = 32U - shr;
+			psrc = (uint32_t *)((uint32_t)src & ~3U);
+			w0 = *psrc++;
+			for(; n >= 4U; n -= 4U){
+				w1 = *psrc++;
+				*pdst++ = (w0 >> shr) | (w1 << shl);
+				w0 = w1;
+			}
+		}
+		/* Tail bytes */
+		src += ((uint8_t *)pdst - dst);
+		dst = (uint8_t *)pdst;
+		while(n--)
+			*dst++ = *src++;
+	}
+	else{									 //backward copy
+		src += length;
+		dst += length;
+		/* Byte copy until the destination end is word aligned */
+		while(((uint32_t)dst & 3U) != 0U){
+			*--dst = *--src;
+			n--;
 		}
-    }
-    else{									 //backward copy
-		src += length-4;
-		dst += length-4;
-		psrc = (uint32_t *) src;
 		pdst = (uint32_t *) dst;
-		for (i=0;i<word_length;i++){
-			*pdst = *psrc;
-			pdst--;
-			psrc--;
+		if(((uint32_t)src & 3U) == 0U){
+			psrc = (uint32_t *) src;
+			for(; n >= 16U; n -= 16U){
+				psrc -= 4;
+				pdst -= 4;
+				w0 = psrc[0]; w1 = psrc[1]; w2 = psrc[2]; w3 = psrc[3];
+				pdst[0] = w0; pdst[1] = w1; pdst[2] = w2; pdst[3] = w3;
+			}
+			for(; n >= 4U; n -= 4U)
+				*--pdst = *--psrc;
 		}
-		for (i=0;i<byte_length;i++){
-			*((uint8_t *)pdst+3) = *((uint8_t *)psrc+3);
-			((uint8_t *)pdst)++;
-			((uint8_t *)psrc)++;
+		else{
+			/* Merge two aligned source words into each destination word */
+			shr = ((uint32_t)src & 3U) << 3;
+			shl = 32U - shr;
+			psrc = (uint32_t *)((uint32_t)src & ~3U);
+			w1 = *psrc;
+			for(; n >= 4U; n -= 4U){
+				w0 = *--psrc;
+				*--pdst = (w0 >> shr) | (w1 << shl);
+				w1 = w0;
+			}
 		}
-    }
-    return SUCCESS;
+		/* Head bytes */
+		src -= (dst - (uint8_t *)pdst);
+		dst = (uint8_t *)pdst;
+		while(n--)
+			*--dst = *--src;
+	}
+	return SUCCESS;
 }
 
 /****************************************************
@@ -120,11 +179,9 @@ int8_t dma_memmove(uint8_t * src, uint8_t * dst, uint32_t length, uint8_t ch){
 }
 
 int8_t dma_memmove_word(uint8_t * src, uint8_t * dst, uint32_t length, uint8_t ch){
-	if (!((pdst <= psrc) || (pdst > (psrc+length)))){
-		
-	}
 	if(!dma_Init_Mem2mem(ch, src, dst, length)){
-		DMA_DCR_REG(DMA_BASE_PTR, ch) |= DMA_DCR_DSIZE(0) | DMA_DCR_AA_MASK;
+		/* Size field 0 selects 32-bit transfers on both sides */
+		DMA_DCR_REG(DMA_BASE_PTR, ch) &= ~(DMA_DCR_SSIZE_MASK | DMA_DCR_DSIZE_MASK);
 		DMA_DCR_REG(DMA_BASE_PTR, ch) |= DMA_DCR_START_MASK;
 		return SUCCESS;
 	}
@@ -133,6 +190,182 @@ int8_t dma_memmove_word(uint8_t * src, uint8_t * dst, uint32_t length, uint8_t c
 	}
 }
 
+static uint32_t memDmaThreshold = MEM_DMA_THRESHOLD_DEFAULT;
+
+static int8_t mem_CopyDma(uint8_t * dst, uint8_t * src, uint32_t length){
+	dma_job_t job;
+	uint32_t words = length & ~3U;
+	
+	if(words == 0U)
+		return my_memmove(src, dst, (int32_t)length);
+	/* No free channel is not an error, the CPU just does the copy */
+	switch(dma_MemcpyAsync(&job, dst, src, words, NULL, NULL)){
+	case status_DMA_Success:
+		break;
+	case status_DMA_Busy:
+		return my_memmove_word(src, dst, (int32_t)length);
+	default:
+		return ERROR;
+	}
+	if(dma_Wait(&job, SYS_WAIT_FOREVER) != status_DMA_Success)
+		return ERROR;
+	if(length != words)
+		return my_memmove(src + words, dst + words, (int32_t)(length - words));
+	return SUCCESS;
+}
+
+/****************************************************
+* @name: mem_Copy
+*
+* @description: copy data from one memory to the other, picking the
+*               CPU or the DMA by size. Copies of at least the DMA
+*               threshold with word-aligned, forward-safe addresses go
+*               to the DMA; everything else uses my_memmove_word. 
+*               The call returns once the data is copied.
+*               
+* @param: dst -- pointer to the destination address
+*         src -- pointer to the source address
+*         length -- lenth of memory bytes to copy
+*
+* @return:SUCCESS/ERROR 
+*/
+int8_t mem_Copy(uint8_t * dst, uint8_t * src, uint32_t length){
+	if((NULL==src)||(NULL==dst))
+		return ERROR;
+	/* The DMA only copies forward, so it can't take a backward overlap */
+	if((length >= memDmaThreshold) &&
+	   ((((uint32_t)dst | (uint32_t)src) & 3U) == 0U) &&
+	   ((dst <= src) || (dst >= (src+length))))
+		return mem_CopyDma(dst, src, length);
+	return my_memmove_word(src, dst, (int32_t)length);
+}
+
+void mem_SetDmaThreshold(uint32_t length){
+	memDmaThreshold = length;
+}
+
+uint32_t mem_GetDmaThreshold(void){
+	return memDmaThreshold;
+}
+
+/****************************************************
+* @name: mem_CalibrateDmaThreshold
+*
+* @description: time the CPU and the DMA copy paths with SysTick at the
+*               core clock for doubling copy sizes, and set the DMA
+*               threshold to the first size where the DMA wins. PIT0
+*               runs the task tick and PIT1 the temperature alarm, so
+*               no PIT channel is free for this. SysTick's setting is
+*               saved and restored around the measurement. The DMA
+*               completes through its interrupt, so interrupts stay
+*               enabled; each path keeps the fastest of
+*               MEM_CALIBRATION_RUNS runs, which drops the runs an
+*               interrupt landed in.
+*
+* @return: the new threshold
+*/
+uint32_t mem_CalibrateDmaThreshold(void){
+	uint8_t * src;
+	uint8_t * dst;
+	uint32_t length, run, start, ticks, cpuTicks, dmaTicks;
+	uint32_t sysTickCtrl, sysTickLoad;
+	uint32_t threshold = MEM_CALIBRATION_MAX_LENGTH + 1U;
+	
+	src = (uint8_t *)malloc(MEM_CALIBRATION_MAX_LENGTH);
+	dst = (uint8_t *)malloc(MEM_CALIBRATION_MAX_LENGTH);
+	if((src != NULL) && (dst != NULL)){
+		sysTickCtrl = SysTick->CTRL;
+		sysTickLoad = SysTick->LOAD;
+		SysTick->CTRL = 0U;
+		SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+		SysTick->VAL = 0U;
+		SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;	// Core clock, no interrupt
+		for(length = 16U; length <= MEM_CALIBRATION_MAX_LENGTH; length <<= 1){
+			cpuTicks = SysTick_LOAD_RELOAD_Msk;
+			dmaTicks = SysTick_LOAD_RELOAD_Msk;
+			for(run = 0; run < MEM_CALIBRATION_RUNS; run++){
+				/* SysTick counts down through 24 bits */
+				start = SysTick->VAL;
+				my_memmove_word(src, dst, (int32_t)length);
+				ticks = (start - SysTick->VAL) & SysTick_LOAD_RELOAD_Msk;
+				if(ticks < cpuTicks)
+					cpuTicks = ticks;
+				
+				start = SysTick->VAL;
+				mem_CopyDma(dst, src, length);
+				ticks = (start - SysTick->VAL) & SysTick_LOAD_RELOAD_Msk;
+				if(ticks < dmaTicks)
+					dmaTicks = ticks;
+			}
+			
+			if(dmaTicks < cpuTicks){
+				threshold = length;
+				break;
+			}
+		}
+			SysTick->CTRL = 0U;
+		SysTick->LOAD = sysTickLoad;
+		SysTick->VAL = 0U;
+		SysTick->CTRL = sysTickCtrl;
+	}
+	free(src);
+	free(dst);
+	memDmaThreshold = threshold;
+	return threshold;
+}
+
+/****************************************************
+* @name: mem_Fill
+*
+* @description: fill memory with a repeating 32-bit pattern. Byte i
+*               of the destination gets byte (i % 4) of the pattern
+*               in little-endian order. The head is filled bytewise
+*               up to a word boundary, the body with 16-byte bursts
+*               of aligned word stores, then the tail bytewise.
+*               
+* @param: dst -- pointer to the memory address
+*         pattern -- 32-bit pattern to repeat
+*         length -- lenth of memory bytes to fill
+*
+* @return:SUCCESS/ERROR 
+*/
+int8_t mem_Fill(uint8_t * dst, uint32_t pattern, uint32_t length){
+	uint32_t * pdst;
+	uint32_t head;
+
+	if(dst == NULL)
+		return ERROR;
+	if(length < MEM_WORD_COPY_MIN){
+		while(length--){
+			*dst++ = (uint8_t)pattern;
+			pattern = (pattern >> 8) | (pattern << 24);
+		}
+		return SUCCESS;
+	}
+	/* Byte fill until the destination is word aligned, rotating the
+	 * pattern so the aligned words continue the same byte sequence */
+	head = (4U - ((uint32_t)dst & 3U)) & 3U;
+	length -= head;
+	while(head--){
+		*dst++ = (uint8_t)pattern;
+		pattern = (pattern >> 8) | (pattern << 24);
+	}
+	pdst = (uint32_t *) dst;
+	for(; length >= 16U; length -= 16U){
+		pdst[0] = pattern; pdst[1] = pattern; pdst[2] = pattern; pdst[3] = pattern;
+		pdst += 4;
+	}
+	for(; length >= 4U; length -= 4U)
+		*pdst++ = pattern;
+	/* Tail bytes */
+	dst = (uint8_t *)pdst;
+	while(length--){
+		*dst++ = (uint8_t)pattern;
+		pattern >>= 8;
+	}
+	return SUCCESS;
+}
+
 /****************************************************
 * @name: my_memzero
 *
@@ -144,34 +377,11 @@ int8_t dma_memmove_word(uint8_t * src, uint8_t * dst, uint32_t length, uint8_t c
 * @return:SUCCESS/ERROR 
 */
 int8_t my_memzero(uint8_t * src, uint32_t length){
-    uint32_t i;
-	if(src == NULL)
-        return ERROR;
-    
-    for(i = 0;i < length;i ++)
-        *(src + i) = 0;
-    return SUCCESS;
+	return mem_Fill(src, 0U, length);
 }
 
 int8_t my_memzero_word(uint8_t * src, uint32_t length){
-    uint32_t i;
-	uint32_t word_length;
-	uint32_t byte_length;
-	uint32_t * psrc;
-	if(src == NULL)
-        return ERROR;
-	word_length = length >> 2;
-	byte_length = length % 4;
-    psrc = (uint32_t *) src;
-    for(i = 0;i < word_length; i++){
-        *psrc  = 0;
-		psrc ++;
-	}
-	for(i = 0;i < byte_length; i++){
-		*(uint8_t *)psrc = 0;
-		((uint8_t *)psrc)++;
-	}
-    return SUCCESS;
+	return mem_Fill(src, 0U, length);
 }
 
 /****************************************************
@@ -186,9 +396,10 @@ int8_t my_memzero_word(uint8_t * src, uint32_t length){
 *
 * @return:SUCCESS/ERROR 
 */
+static const uint32_t dma_ZeroWord = 0U;	// Source of the zeroing transfers, must outlive them
+
 int8_t dma_memzero(uint8_t * src, uint32_t length, uint8_t ch){
-	uint8_t temp=0;
-	if(!dma_Init_Mem2mem(ch, &temp, src, length)){
+	if(!dma_Init_Mem2mem(ch, (uint8_t *)&dma_ZeroWord, src, length)){
 		DMA_DCR_REG(DMA_BASE_PTR, ch) &= ~DMA_DCR_SINC_MASK;
 		DMA_DCR_REG(DMA_BASE_PTR, ch) |= DMA_DCR_START_MASK;
 		return SUCCESS;
@@ -198,10 +409,9 @@ int8_t dma_memzero(uint8_t * src, uint32_t length, uint8_t ch){
 }
 
 int8_t dma_memzero_word(uint8_t * src, uint32_t length, uint8_t ch){
-	uint8_t temp=0;
-	if(!dma_Init_Mem2mem(ch, &temp, src, length)){
-		DMA_DCR_REG(DMA_BASE_PTR, ch) &= ~DMA_DCR_SINC_MASK;
-		DMA_DCR_REG(DMA_BASE_PTR, ch) |= DMA_DCR_DSIZE(0) | DMA_DCR_AA_MASK;
+	if(!dma_Init_Mem2mem(ch, (uint8_t *)&dma_ZeroWord, src, length)){
+		DMA_DCR_REG(DMA_BASE_PTR, ch) &= ~(DMA_DCR_SINC_MASK | DMA_DCR_SSIZE_MASK | DMA_DCR_DSIZE_MASK);
+		DMA_DCR_REG(DMA_BASE_PTR, ch) |= DMA_DCR_AA_MASK;
 		DMA_DCR_REG(DMA_BASE_PTR, ch) |= DMA_DCR_START_MASK;
 		return SUCCESS;
 	}
@@ -221,15 +431,117 @@ int8_t dma_memzero_word(uint8_t * src, uint32_t length, uint8_t ch){
 * @return:SUCCESS/ERROR 
 */
 int8_t my_reverse(uint8_t * str, uint32_t length){
-    uint8_t temp;
-    uint32_t i=0;
-    if (str == NULL)
-        return ERROR;
-    while((i) < (length-1-i)){
-        temp = *(str+i);
-        *(str+i) = *(str+length-1-i);
-        *(str+length-1-i) = temp;
-        i++;
-    }
-    return SUCCESS;
+	uint8_t * left;
+	uint8_t * right;
+	uint32_t * pleft;
+	uint32_t wl, wr;
+	uint8_t temp;
+
+	if (str == NULL)
+		return ERROR;
+	left = str;
+	right = str + length;					// One past the last byte
+	/* Byte swaps until the left end is word aligned */
+	while((((uint32_t)left & 3U) != 0U) && (right - left > 1)){
+		temp = *left;
+		*left++ = *--right;
+		*right = temp;
+	}
+	/* Swap reversed 4-byte chunks from both ends */
+	pleft = (uint32_t *) left;
+	if(((uint32_t)right & 3U) == 0U){
+		uint32_t * pright = (uint32_t *) right;
+		while((uint8_t *)pright - (uint8_t *)pleft >= 8){
+			wl = *pleft;
+			wr = *--pright;
+			*pleft++ = __REV(wr);
+			*pright = __REV(wl);
+		}
+		right = (uint8_t *) pright;
+	}
+	else{
+		/* The right end stays unaligned: gather it reversed bytewise */
+		while(right - (uint8_t *)pleft >= 8){
+			wl = *pleft;
+			right -= 4;
+			wr = (uint32_t)right[3] | ((uint32_t)right[2] << 8) |
+				 ((uint32_t)right[1] << 16) | ((uint32_t)right[0] << 24);
+			*pleft++ = wr;
+			right[0] = (uint8_t)(wl >> 24);
+			right[1] = (uint8_t)(wl >> 16);
+			right[2] = (uint8_t)(wl >> 8);
+			right[3] = (uint8_t)wl;
+		}
+	}
+	/* Middle bytes */
+	left = (uint8_t *) pleft;
+	while(right - left > 1){
+		temp = *left;
+		*left++ = *--right;
+		*right = temp;
+	}
+	return SUCCESS;
+}
+
+/****************************************************
+* @name: mem_Bswap16_Array
+*
+* @description: swap the byte order of each 16-bit element in place,
+*               two elements per word when the array is word aligned
+*               
+* @param: data -- pointer to the array
+*         count -- number of elements
+*
+* @return:SUCCESS/ERROR 
+*/
+int8_t mem_Bswap16_Array(uint16_t * data, uint32_t count){
+	uint32_t * pword;
+
+	if (data == NULL)
+		return ERROR;
+	if((count != 0U) && (((uint32_t)data & 3U) != 0U)){
+		*data = (uint16_t)__REV16(*data);
+		data++;
+		count--;
+	}
+	pword = (uint32_t *) data;
+	for(; count >= 8U; count -= 8U){
+		pword[0] = __REV16(pword[0]); pword[1] = __REV16(pword[1]);
+		pword[2] = __REV16(pword[2]); pword[3] = __REV16(pword[3]);
+		pword += 4;
+	}
+	for(; count >= 2U; count -= 2U){
+		*pword = __REV16(*pword);
+		pword++;
+	}
+	if(count != 0U){
+		data = (uint16_t *) pword;
+		*data = (uint16_t)__REV16(*data);
+	}
+	return SUCCESS;
+}
+
+/****************************************************
+* @name: mem_Bswap32_Array
+*
+* @description: swap the byte order of each 32-bit element in place
+*               
+* @param: data -- pointer to the word aligned array
+*         count -- number of elements
+*
+* @return:SUCCESS/ERROR 
+*/
+int8_t mem_Bswap32_Array(uint32_t * data, uint32_t count){
+	if (data == NULL)
+		return ERROR;
+	for(; count >= 4U; count -= 4U){
+		data[0] = __REV(data[0]); data[1] = __REV(data[1]);
+		data[2] = __REV(data[2]); data[3] = __REV(data[3]);
+		data += 4;
+	}
+	while(count--){
+		*data = __REV(*data);
+		data++;
+	}
+	return SUCCESS;
 }
@@ -158,12 +158,12 @@ system_status_t SYS_SemaDestroy(semaphore_t *pSem)
 msg_queue_handler_t SYS_MsgQueueCreate(msg_queue_t *queue, uint8_t queue_size)
 {
 	assert(queue);
+	assert(queue_size < 0xFF);
 	
-	queue->size = queue_size;
-	queue->queueMem = (uint8_t *)malloc(sizeof(uint8_t)*queue_size);
+	queue->size = queue_size + 1;
+	queue->queueMem = (uint8_t *)malloc(sizeof(uint8_t)*queue->size);
 	queue->head = 0;
 	queue->tail = 0;
-	queue->isEmpty = true;
 	
 	return queue;
 }
@@ -172,85 +172,59 @@ system_status_t SYS_MsgEnqueue(msg_queue_handler_t handler, void* pMsg)
 {
 	assert(handler);
 	
-	uint8_t *pFrom;
-	uint8_t *pTo;
+	uint8_t tail = handler->tail;
+	uint8_t next = tail + 1;
 	
-	/* Prevent the enqueue process from being interrupted */
-	SYS_DisableIRQGlobal();
-	
-	/* Check if there is room in the queue for new message */
-	if((handler->tail != handler->head) || (handler->isEmpty))
+	/* Wrap the tail index in case the end of the buffer is reached */
+	if(next == handler->size)
 	{
-		pFrom = (uint8_t *) pMsg;
-		pTo	= &handler->queueMem[handler->tail];
-		//pTo	= handler->queueMem;
-		
-		*pTo = *pFrom;
-		
-		++handler->tail;
-		
-	/* Wrap the tail pointer in case the end of the buffer is reached */
-		if(handler->tail == handler->size)
-		{
-			handler->tail = 0;
-		}
-		
-	/* If the queue was empty, signal the empty flag */
-		if(handler->isEmpty)
-		{
-			handler->isEmpty = false;
-		}
-		
-		SYS_EnableIRQGlobal();
-		return status_SYS_Success;
+		next = 0;
 	}
-	else
+	
+	/* Check if there is room in the queue for new message */
+	if(next == handler->head)
 	{
-		SYS_EnableIRQGlobal();
 		return status_SYS_Error;
 	}
 	
+	handler->queueMem[tail] = *(uint8_t *)pMsg;
+	
+	/* Publish the message only after it is written */
+	SYS_MemoryBarrier();
+	handler->tail = next;
+	
+	return status_SYS_Success;
 }
 
 system_status_t SYS_MsgDequeue(msg_queue_handler_t handler, void* pMsg)
 {
 	assert(handler);
 	
-	uint8_t *pFrom, *pTo;
-	
-	/* Prevent the enqueue process from being interrupted */
-	SYS_DisableIRQGlobal();
+	uint8_t head = handler->head;
+	uint8_t next;
 	
 	/* Check if the queue is not empty */
-	if(!handler->isEmpty)
+	if(head == handler->tail)
 	{
-		pFrom = &handler->queueMem[handler->head];
-		pTo = (uint8_t*)pMsg;
-		
-		*pTo = *pFrom;
-		
-		++handler->head;
-		
-	/* Wrap the head pointer in case the end of the buffer is reach */
-		if(handler->head == handler->size)
-		{
-			handler->head = 0;
-		}
-	
-	/*If queue is empty, signal the empty flag */
-		if(handler->head == handler->tail)
-		{
-			handler->isEmpty = true;
-		}
-		
-		SYS_EnableIRQGlobal();
-		return status_SYS_Success; 
+		return status_SYS_Error;
 	}
-	else
+	
+	/* Read the message only after its tail update is seen */
+	SYS_MemoryBarrier();
+	*(uint8_t *)pMsg = handler->queueMem[head];
+	
+	next = head + 1;
+	/* Wrap the head index in case the end of the buffer is reached */
+	if(next == handler->size)
 	{
-		SYS_EnableIRQGlobal();
-		return status_SYS_Error;
+		next = 0;
 	}
+	
+	/* Release the slot only after the message is read */
+	SYS_MemoryBarrier();
+	handler->head = next;
+	
+	return status_SYS_Success; 
 }
 
 uint32_t SYS_TimeDiff(uint32_t time_start, uint32_t time_end)
@@ -18,31 +18,77 @@ volatile uint16_t pitCounter = 0;
 
 tsi_state_t tsiState;
 uint8_t tsi_Channel[BOARD_TSI_ELECTRODE_CNT];
-uint32_t unTouch;
+tsi_baseline_t tsiBaseline[BOARD_TSI_ELECTRODE_CNT];
+
+/* Counters of the last finished scan, copied in the TSI ISR and
+ * owned by the main loop until ST_processTouchReadyMsg is done */
+static uint16_t tsiSnapshot[BOARD_TSI_ELECTRODE_CNT];
+static volatile bool tsiSnapshotPending = false;
+
+static volatile uint16_t tempRaw;		// Latest temperature sensor code from the ADC ISR
 
 static void ST_TaskInit(void);
 static void ST_processAppMsg(uint8_t *pMsg);
 static void ST_processReadTempEvt(void);
-static void ST_processSenseTouchEvt(void);
+static void ST_processTempReadyMsg(void);
+static void ST_processTouchReadyMsg(void);
 
 void PIT_User_Callback(void)
 {
 	++pitCounter;
 	
-	event |= ST_SENSE_TOUCH_EVT;
+	/* The tick paces the touch scans; the scan itself runs from
+	 * the TSI interrupt and ends in ST_TouchScanCallback */
+	if(TSI_GetStatus() == status_TSI_Initialized)
+	{
+		TSI_Measure();
+	}
 	
+#if !ST_TEMP_HW_ALARM
 	if(pitCounter == 500)
 	{
 		event |= ST_READ_TEMP_EVT;
 	}
+#endif
 	if(pitCounter == 1000)
 	{
+#if !ST_TEMP_HW_ALARM
 		event |= ST_READ_TEMP_EVT;
+#endif
  		event |= ST_BLINK_LED_EVT;
 		pitCounter = 0;
 	}
 }
 
+static void ST_TempConvCallback(adc16_Ch_t ch, uint16_t value)
+{
+	uint8_t msg = ST_TEMP_READY_MSG;
+#if ST_TEMP_HW_ALARM
+	/* One reading per window crossing, re-armed from the main loop */
+	ADC_StopMonitor();
+#endif
+	tempRaw = value;
+	SYS_MsgEnqueue(msgQueue_Handler, &msg);
+}
+
+static void ST_TouchScanCallback(void *usrData)
+{
+	uint8_t msg = ST_TOUCH_READY_MSG;
+	uint8_t i;
+	
+	/* Drop the scan if the main loop still has the last one */
+	if(tsiSnapshotPending)
+	{
+		return;
+	}
+	for(i = 0; i < BOARD_TSI_ELECTRODE_CNT; i++)
+	{
+		tsiSnapshot[i] = tsiState.counters[tsi_Channel[i]];
+	}
+	tsiSnapshotPending = true;
+	SYS_MsgEnqueue(msgQueue_Handler, &msg);
+}
+
 void PORTD_IRQHandler(void)
 {
 	uint8_t msg = ST_KEY_PRESSED_MSG;
@@ -52,6 +98,7 @@ void PORTD_IRQHandler(void)
 static void ST_TaskInit(void)
 {
 	uint8_t i;
+	tsi_status_t tsiStatus;
 	
 	static const lptmr_user_config_t lptmrUserConfig = 
 	{
@@ -77,7 +124,7 @@ static void ST_TaskInit(void)
 	const tsi_user_config_t tsiUserConfig = 
 	{
 		.config = (tsi_config_t *)&tsiHwConfig,
-		.callback = NULL,
+		.callback = NULL,		// Installed once the message queue exists
 		.usrData = 0
 	};
 	
@@ -108,7 +155,14 @@ static void ST_TaskInit(void)
 	{
 		TSI_EnableElectrode(tsi_Channel[i], true);
 	}
-	unTouch = TSI_GetUnTouchBaseline(tsi_Channel);
+	for(i = 0; i < ST_TSI_BASELINE_TRIES; i++)
+	{
+		tsiStatus = TSI_BaselineInit(tsiBaseline, tsi_Channel, BOARD_TSI_ELECTRODE_CNT);
+		if(tsiStatus == status_TSI_Success)
+		{
+			break;
+		}
+	}
 	
 	/* UART0 for logging Initialization */
 	uart0_Init(9600,0,0,8,1);
@@ -116,13 +170,40 @@ static void ST_TaskInit(void)
 	/* Construct a message queue */
 	msgQueue_Handler = SYS_MsgQueueCreate(&msgQueue, ST_MSG_QUEUE_SIZE);
 	
+	/* The scan callback enqueues, so it may only run from here on, after
+	 * the blocking baseline scans and with the queue in place. Without a
+	 * baseline the touch sensing stays off. */
+	if(tsiStatus == status_TSI_Success)
+	{
+		TSI_SetCallbackFunc(ST_TouchScanCallback, NULL);
+	}
+	else
+	{
+		log_Event1(TSI_BASELINE_FAILED, (int32_t)tsiStatus);
+	}
+	
 	/* System Interrupt setting */
 	// Configure interrupts' priorities 
+	// The message queue producers must not preempt each other
+	NVIC_SetPriority(PORTD_IRQn, ST_MSG_IRQ_PRIORITY);
+	NVIC_SetPriority(ADC0_IRQn, ST_MSG_IRQ_PRIORITY);
+	NVIC_SetPriority(TSI0_IRQn, ST_MSG_IRQ_PRIORITY);
 	SYS_EnableIRQGlobal(); // Enable system interrupt
 	
+	/* Needs the DMA interrupt; done before the tick so fewer runs are hit */
+	mem_CalibrateDmaThreshold();
+	
 	PIT_StartTimer(0);
 	
-	log_Raw(SYSTEM_INITIALIZED);
+#if ST_TEMP_HW_ALARM
+	/* Only a reading outside the window reaches the CPU. PIT1 belongs to
+	 * the alarm from here on; mem_CalibrateDmaThreshold times with SysTick
+	 * so it can run at any point without stopping it. */
+	temp_StartAlarm(ST_TEMP_LOW_CENTI, ST_TEMP_HIGH_CENTI, false,
+					adcTriggerPit1, ST_TEMP_ALARM_PERIOD_US, ST_TempConvCallback);
+#endif
+	
+	log_Event(SYSTEM_INITIALIZED);
 }
 
 void ST_TaskFunc(void)
@@ -133,7 +214,7 @@ void ST_TaskFunc(void)
 	{
 		// Entering low power mode -- semaphore pending state
 		//smc_Hal_SetPowerMode(&powerMode);
-		//log_Raw(SYSTEM_ENTERED_WAIT);
+		//log_Event(SYSTEM_ENTERED_WAIT);
 	/* Process app message */
 		while (status_SYS_Success == SYS_MsgDequeue(msgQueue_Handler, &msg))
 		{
@@ -144,12 +225,6 @@ void ST_TaskFunc(void)
 		}
 		
 	/* Perform periodic tasks */
-		if(event & ST_SENSE_TOUCH_EVT)
-		{
-			event &= ~ST_SENSE_TOUCH_EVT;
-			ST_processSenseTouchEvt();
-		}
-		
 		if(event & ST_READ_TEMP_EVT)
 		{
 			event &= ~ST_READ_TEMP_EVT;// clear event bits
@@ -164,7 +239,7 @@ void ST_TaskFunc(void)
 				//BLINK LED
 				LED2_OFF;
 				LED1_TOGGLE;
-				log_Raw(SYSTEM_NORMAL);
+				log_Event(SYSTEM_NORMAL);
 			}
 			else
 			{
@@ -173,6 +248,12 @@ void ST_TaskFunc(void)
 				
 			}
 		}
+		
+	/* Format deferred logs only when there is nothing else to do */
+		if((!event) && SYS_MsgQueueIsEmpty(msgQueue_Handler))
+		{
+			log_Process();
+		}
 	}
 }
 
@@ -189,64 +270,76 @@ static void ST_processAppMsg(uint8_t *pMsg)
 			LED2_OFF;
 			LED3_OFF;
 			break;
+		
+		case ST_TEMP_READY_MSG:
+			ST_processTempReadyMsg();
+			break;
+		
+		case ST_TOUCH_READY_MSG:
+			ST_processTouchReadyMsg();
+			break;
 			
 		default:	//do nothing
 			break;
 	}
 }
 static void ST_processReadTempEvt(void)
+{
+	/* The result comes back as ST_TEMP_READY_MSG; if the last
+	 * conversion is still running this reading is skipped */
+	ADC_StartConv(adc16_TempSensor, ST_TempConvCallback);
+}
+
+static void ST_processTempReadyMsg(void)
 {
 	int32_t temp;
 	
-	log_Raw(READING_SYS_TEMPERATURE);
-	temp = read_OnChipTemperature(); 
-	log_Raw((uint8_t)temp);
-	/* check if temperature is abnormal */
-	if((temp > 27) || (temp < 20))
+	temp = temp_ConvertRaw(tempRaw); 
+	log_Event1(READING_SYS_TEMPERATURE, temp);
+#if ST_TEMP_HW_ALARM
+	/* The compare window only lets a reading through when it crosses
+	 * the window edge; wait for the crossing back the other way */
+	system_alarm = !system_alarm;
+	temp_StartAlarm(ST_TEMP_LOW_CENTI, ST_TEMP_HIGH_CENTI, system_alarm,
+					adcTriggerPit1, ST_TEMP_ALARM_PERIOD_US, ST_TempConvCallback);
+#else
+	/* check if temperature is abnormal, temp is in 0.01 oC */
+	system_alarm = (temp > ST_TEMP_HIGH_CENTI) || (temp < ST_TEMP_LOW_CENTI);
+#endif
+	if(system_alarm)
 	{
-		system_alarm = true;
-		log_Raw(SYSTEM_TEMPERATURE_NORMAL);
+		log_Event(SYSTEM_TEMPERATURE_OUTOFRANGE);
 	}
 	else
 	{
-		system_alarm = false;
-		log_Raw(SYSTEM_TEMPERATURE_OUTOFRANGE);
+		log_Event(SYSTEM_TEMPERATURE_NORMAL);
 	}
 }
 
-static void ST_processSenseTouchEvt(void)
+static void ST_processTouchReadyMsg(void)
 {
 	uint8_t i;
-	uint16_t measureResult[BOARD_TSI_ELECTRODE_CNT];
-	uint32_t avgMeasure;
+	uint32_t touchedCounter = 0;
 	
-	if(TSI_MeasureBlocking() != status_TSI_Success)
+	/* Each electrode has its own baseline and noise threshold, which
+	 * keep tracking while it is released */
+	for(i = 0; i < BOARD_TSI_ELECTRODE_CNT; i++)
 	{
-		return;
+		if(TSI_BaselineUpdate(&tsiBaseline[i], tsiSnapshot[i]))
+		{
+			touchedCounter = tsiSnapshot[i];
+		}
 	}
+	tsiSnapshotPending = false;
 
-	// Init average measurement.
-  avgMeasure = 0;
-    for(i = 0; i < BOARD_TSI_ELECTRODE_CNT; i++)
-    {
-			if(TSI_GetCounter(tsi_Channel[i], &measureResult[i]) != status_TSI_Success)
-			{
-				return;
-      }
-      avgMeasure += measureResult[i];
-    }
-    // Calculates average measurement.
-    avgMeasure /= BOARD_TSI_ELECTRODE_CNT;
-
-    // Check if it's the touched state.
-	// Add 10 to remove noise
-    if(avgMeasure > unTouch + 10)
-    {
-        LED3_ON;
-				log_Raw(SYSTEM_SENSED_TOUCH);
-    }
-    else
-    {
-        LED3_OFF;
-    }
+	// Check if it's the touched state.
+	if(touchedCounter)
+	{
+		LED3_ON;
+		log_Event1(SYSTEM_SENSED_TOUCH, touchedCounter);
+	}
+	else
+	{
+		LED3_OFF;
+	}
 }
@@ -222,34 +222,208 @@ tsi_status_t TSI_GetCounter(const uint32_t channel, uint16_t *counter)
     return status_TSI_Success;
 }
 
-uint32_t TSI_GetUnTouchBaseline(uint8_t * tsiChn)
+/****************************************************
+* @name: TSI_Sqrt
+*
+* @description: integer square root, bit by bit
+*/
+static uint32_t TSI_Sqrt(uint32_t num)
 {
-	uint8_t i, j;
-	uint16_t tsi_MeasureResult[BOARD_TSI_ELECTRODE_CNT];
-	uint32_t sum_Untouch = 0U;
-	uint32_t avg_Untouch = 0U;
+	uint32_t root = 0;
+	uint32_t bit = 1UL << 30;
 	
+	while(bit > num)
+	{
+		bit >>= 2;
+	}
+	while(bit)
+	{
+		if(num >= root + bit)
+		{
+			num -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+		{
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return root;
+}
+
+/****************************************************
+* @name: TSI_BaselineSetThresholds
+*
+* @description: derive the touch and release deltas from the
+*               tracked noise variance
+*/
+static void TSI_BaselineSetThresholds(tsi_baseline_t *baseline)
+{
+	/* The root of a Q8 variance is the standard deviation in Q4 */
+	uint32_t touch = (TSI_TOUCH_SIGMA * TSI_Sqrt(baseline->variance)) >> (TSI_BASELINE_FRAC_BITS / 2U);
+	
+	if(touch < TSI_BASELINE_MIN_DELTA)
+	{
+		touch = TSI_BASELINE_MIN_DELTA;
+	}
+	else if(touch > 0xFFFFU)
+	{
+		touch = 0xFFFFU;
+	}
+	baseline->touchDelta = (uint16_t)touch;
+	baseline->releaseDelta = (uint16_t)(touch >> 1);
+}
+
+/****************************************************
+* @name: TSI_BaselineSeed
+*
+* @description: restart a tracker at counter, released, keeping the
+*               noise variance it has
+*/
+static void TSI_BaselineSeed(tsi_baseline_t *baseline, uint16_t counter)
+{
+	baseline->baseline = (uint32_t)counter << TSI_BASELINE_FRAC_BITS;
+	baseline->touched = false;
+	baseline->touchScans = 0;
+	TSI_BaselineSetThresholds(baseline);
+}
+
+tsi_status_t TSI_BaselineInit(tsi_baseline_t *baseline, const uint8_t *tsiChn, uint8_t count)
+{
+	uint16_t first[MAX_TSI_CHANNEL_INDEX];
+	int32_t sum[MAX_TSI_CHANNEL_INDEX];
+	uint32_t sumSq[MAX_TSI_CHANNEL_INDEX];
+	uint16_t counter;
+	int32_t dev;
+	int64_t var;
+	uint32_t i, j;
 	tsi_status_t tsi_Status;
 	
-	tsi_Status = TSI_MeasureBlocking();
-	if(tsi_Status != status_TSI_Success)
+	if((!baseline) || (!tsiChn) || (!count) || (count > MAX_TSI_CHANNEL_INDEX))
 	{
-		return -1;
+		return status_TSI_InvalidChannel;
 	}
-	for (i=0; i < TSI_THRESHOLD_SAMPLING; i++)
+	/* Every sample is a new scan. Deviations are taken from the
+	 * first reading so the sums stay small. */
+	for(i = 0; i < TSI_THRESHOLD_SAMPLING; i++)
 	{
-		for(j = 0; j < BOARD_TSI_ELECTRODE_CNT; j++)
+		tsi_Status = TSI_MeasureBlocking();
+		if(tsi_Status != status_TSI_Success)
 		{
-			tsi_Status = TSI_GetCounter(tsiChn[j], &tsi_MeasureResult[j]);
+			return tsi_Status;
+		}
+		for(j = 0; j < count; j++)
+		{
+			tsi_Status = TSI_GetCounter(tsiChn[j], &counter);
 			if(tsi_Status != status_TSI_Success)
 			{
-				return -1;
+				return tsi_Status;
+			}
+			if(i == 0)
+			{
+				first[j] = counter;
+				sum[j] = 0;
+				sumSq[j] = 0;
+			}
+			dev = (int32_t)counter - (int32_t)first[j];
+			if(dev > (int32_t)TSI_NOISE_MAX_DELTA)
+			{
+				dev = TSI_NOISE_MAX_DELTA;
+			}
+			else if(dev < -(int32_t)TSI_NOISE_MAX_DELTA)
+			{
+				dev = -(int32_t)TSI_NOISE_MAX_DELTA;
 			}
-			sum_Untouch += tsi_MeasureResult[j];
+			sum[j] += dev;
+			sumSq[j] += (uint32_t)(dev * dev);
+		}
+	}
+	for(j = 0; j < count; j++)
+	{
+		baseline[j].baseline = ((uint32_t)first[j] << TSI_BASELINE_FRAC_BITS) +
+							   (uint32_t)(((int64_t)sum[j] << TSI_BASELINE_FRAC_BITS) / (int32_t)TSI_THRESHOLD_SAMPLING);
+		/* n * var = sum(d^2) - sum(d)^2 / n */
+		var = (((int64_t)sumSq[j] << TSI_BASELINE_FRAC_BITS) -
+			   (((int64_t)sum[j] * sum[j]) << TSI_BASELINE_FRAC_BITS) / (int32_t)TSI_THRESHOLD_SAMPLING) /
+			  (int32_t)TSI_THRESHOLD_SAMPLING;
+		baseline[j].variance = (var > 0) ? (uint32_t)var : 0U;
+		baseline[j].touched = false;
+		baseline[j].touchScans = 0;
+		TSI_BaselineSetThresholds(&baseline[j]);
+		LOG_DBG(MOD_TSI, Int, (uint8_t *)"tsi baseline ", baseline[j].baseline >> TSI_BASELINE_FRAC_BITS);
+		LOG_DBG(MOD_TSI, Int, (uint8_t *)"tsi touch delta ", baseline[j].touchDelta);
+	}
+	return status_TSI_Success;
+}
+
+bool TSI_BaselineUpdate(tsi_baseline_t *baseline, uint16_t counter)
+{
+	int32_t error = ((int32_t)counter << TSI_BASELINE_FRAC_BITS) - (int32_t)baseline->baseline;
+	int32_t delta = error >> TSI_BASELINE_FRAC_BITS;		// Counts above the baseline
+	uint32_t dev, square;
+	
+	/* Never seeded, e.g. TSI_BaselineInit failed: every reading would
+	 * count as a touch, take this one as the untouched level instead */
+	if(baseline->touchDelta == 0U)
+	{
+		TSI_BaselineSeed(baseline, counter);
+		return false;
+	}
+	if(baseline->touched)
+	{
+		if((delta >= (int32_t)baseline->releaseDelta) &&
+		   (++baseline->touchScans < TSI_BASELINE_MAX_TOUCH))
+		{
+			return true;
+		}
+		if(baseline->touchScans >= TSI_BASELINE_MAX_TOUCH)
+		{
+			/* Held far too long for a finger, the untouched level moved */
+			TSI_BaselineSeed(baseline, counter);
+			return false;
+		}
+		baseline->touched = false;
+	}
+	else if(delta >= (int32_t)baseline->touchDelta)
+	{
+		baseline->touched = true;
+		baseline->touchScans = 0;
+		return true;
+	}
+	
+	/* Released: readings below the baseline mean it is stale and is
+	 * pulled down quickly */
+	if(error < 0)
+	{
+		baseline->baseline -= (uint32_t)(-error) >> TSI_BASELINE_RECOVER_SHIFT;
+	}
+	/* Only readings within the release band are noise. Above it a finger
+	 * is hovering or on its way in or out, and learning from those would
+	 * drift the baseline up and widen the thresholds. */
+	dev = (delta < 0) ? (uint32_t)(-delta) : (uint32_t)delta;
+	if(dev < baseline->releaseDelta)
+	{
+		if(error >= 0)
+		{
+			baseline->baseline += (uint32_t)error >> TSI_BASELINE_DRIFT_SHIFT;
+		}
+		if(dev > TSI_NOISE_MAX_DELTA)
+		{
+			dev = TSI_NOISE_MAX_DELTA;
+		}
+		square = (dev * dev) << TSI_BASELINE_FRAC_BITS;
+		if(square < baseline->variance)
+		{
+			baseline->variance -= (baseline->variance - square) >> TSI_NOISE_SHIFT;
+		}
+		else
+		{
+			baseline->variance += (square - baseline->variance) >> TSI_NOISE_SHIFT;
 		}
 	}
-	avg_Untouch = sum_Untouch / (TSI_THRESHOLD_SAMPLING * BOARD_TSI_ELECTRODE_CNT);
-	return avg_Untouch;
+	TSI_BaselineSetThresholds(baseline);
+	return false;
 }
 
 void TSI0_IRQHandler(void)
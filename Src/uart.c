@@ -11,8 +11,45 @@
 
 uint32_t SystemBusClock = DEFAULT_BUS_CLOCK;
 
-uint8_t  tx_buf; 
-uint8_t  rx_buf;
+CircBuf_t   txCircBuf;
+CircBuf_t   rxCircBuf;
+CircBuf_t * tx_buf = NULL; 
+CircBuf_t * rx_buf = NULL;
+
+static uart0_rx_callback_t rxFrameCallback = NULL;
+static uint32_t rxFrameLength = 0;			// Bytes received since the last idle line
+
+#if UART0_TX_DMA_ENABLE
+static volatile uint32_t txDmaLength = 0;	// Bytes of tx_buf being sent by the DMA, 0 when idle
+static uint8_t txDmaCh = DMA_CHANNEL_NONE;	// Taken from the DMA channel pool by uart0_Init
+
+static void uart0_TxDmaArm(void)
+{
+	uint8_t *pData;
+	uint32_t length;
+	
+	/* Send the largest linear region of the TX buffer straight from its memory */
+	if(cb_PeekContiguous(tx_buf, &pData, &length) != NORMAL)
+	{
+		txDmaLength = 0;
+		return;
+	}
+	/* The span must be recorded before the request is enabled: the DMA can
+	 * finish it and uart0_TxDmaComplete commit it right after ERQ is set */
+	txDmaLength = length;
+	if(dma_Init_Mem2Per(txDmaCh, UART0_TX_DMA_SOURCE, pData, (uint8_t *)&UART0_D, length))
+	{
+		txDmaLength = 0;
+	}
+}
+
+static void uart0_TxDmaComplete(uint8_t dma_ch)
+{
+	assert(dma_ch == txDmaCh);
+	cb_Commit(tx_buf, txDmaLength);
+	uart0_TxDmaArm();
+}
+#endif
 
 void uart0_Init( uint32_t ulBaudRate,
 				 uint8_t  ucParityEnable,
@@ -68,17 +105,31 @@ void uart0_Init( uint32_t ulBaudRate,
 	/* Clear receive buffer */
 	while((UART0_S1 & UART0_S1_RDRF_MASK) &&(UART0_D)); 
 	
+	/* Initialize TX and RX circular buffer */
+	tx_buf = cb_Init(&txCircBuf, UART0_TX_BUF_SIZE);
+	rx_buf = cb_Init(&rxCircBuf, UART0_RX_BUF_SIZE);
+	rxFrameLength = 0;
+	
+	/* Start counting idle characters after the stop bit so a frame ends
+	 * only on a real gap in the line */
+	UART0_C1 |= UART0_C1_ILT_MASK;
+	
 	#if UART0_DEFAULT_OPEN
 		uart0_TranCtl(UART_TX_ENABLE, UART_RX_ENABLE);
 	#endif
 	
 	#if UART0_IRQ_ENABLE
-        UART0_C2 |= UART0_C2_RIE_MASK;      
+        UART0_C2 |= UART0_C2_RIE_MASK | UART0_C2_ILIE_MASK;      
 		NVIC_EnableIRQ(UART0_IRQn);
 		NVIC_SetPriority(UART0_IRQn,3); 
 	#endif
 	
-	/* Initialize TX and RX circular buffer */
+	#if UART0_TX_DMA_ENABLE
+		txDmaCh = dma_ChannelAlloc();
+		assert(txDmaCh != DMA_CHANNEL_NONE);
+		dma_SetCallback(txDmaCh, uart0_TxDmaComplete);
+		ENABLE_UART0_TX_DMA;
+	#endif
 }
 
 void uart0_TranCtl(uint8_t ucTxEnable, 
@@ -89,39 +140,99 @@ void uart0_TranCtl(uint8_t ucTxEnable,
                 (ucRxEnable << UART0_C2_RE_SHIFT);
 }
 
+void uart0_SetRxCallback(uart0_rx_callback_t callback)
+{
+	rxFrameCallback = callback;
+}
+
+uint32_t uart0_Read(uint8_t *pBuf, uint32_t max)
+{
+	return cb_DequeueBulk(rx_buf, pBuf, max);
+}
+
 uint8_t uart0_GetChar(void)
 {
-    while (!(UART0_S1 & UART0_S1_RDRF_MASK));                   
-    return (uint8_t )UART0_D;                                              
+    uint8_t data;
+    while (cb_Dequeue(rx_buf, &data) != NORMAL);                   
+    return data;                                              
+}
+
+/* Start draining tx_buf if the transmitter is idle. When the DMA is used the
+ * completion interrupt re-arms it for the next span, so this only has to be
+ * called after enqueuing. */
+void uart0_TxStart(void)
+{
+#if UART0_TX_DMA_ENABLE
+	uint32_t primask;
+	
+	/* Test and arm as one step, or the DMA ISR or another logging ISR
+	 * could arm the channel in between and the span would go out twice */
+	primask = SYS_SaveDisableIRQ();
+	if(txDmaLength == 0)
+	{
+		uart0_TxDmaArm();
+	}
+	SYS_RestoreIRQ(primask);
+#else
+	if((cb_IsEmpty(tx_buf)!=EMPTY)&&(!(UART0_C2 & UART0_C2_TIE_MASK)))
+		UART0_C2 |= UART0_C2_TIE_MASK;
+#endif
 }
 
 void log_Raw(uint8_t ucCh)
 {
-    while(!(UART0_S1 & UART0_S1_TDRE_MASK));                  
-    UART0_D = ucCh;                                           
+    cb_Enqueue(tx_buf, ucCh);
+    uart0_TxStart();
 }
 
 void uart0_SendString(int8_t *pData)
 {
-    while (*pData != '\0') { 
-        log_Raw(*pData++);
-    }    
+    cb_EnqueueBulk(tx_buf, (uint8_t *)pData, strlen((const char *)pData));
+    uart0_TxStart();
 }
 
 
 void UART0_IRQHandler(void)
 {     
-	__asm("cpsid i");
-	/*if(UART0_S1 & UART0_S1_TDRE_MASK)
+	uint8_t status = UART0_S1;
+	uint32_t length;
+	
+	if((UART0_C2 & UART0_C2_TIE_MASK) && (status & UART0_S1_TDRE_MASK))
 	{
-		tx_buf = UART0_D;
-		UART0_C2 &= ~UART0_C2_TIE_MASK;
-  } */                                                                           
+		uint8_t data;
+		if(cb_Dequeue(tx_buf, &data) == NORMAL)
+		{
+			UART0_D = data;
+		}
+		else
+		{
+			UART0_C2 &= ~UART0_C2_TIE_MASK;
+		}
+	}
                                                                                   
-	if(UART0_S1 & UART0_S1_RDRF_MASK)
+	if(status & UART0_S1_RDRF_MASK)
 	{                        
-		rx_buf = (uint8_t)UART0_D;
-  }   
-   __asm("cpsie i");
+		/* Bytes are dropped if the application falls a whole buffer behind */
+		if(cb_Enqueue(rx_buf, (uint8_t)UART0_D) == NORMAL)
+		{
+			++rxFrameLength;
+		}
+	}
+	
+	if(status & UART0_S1_OR_MASK)
+	{
+		UART0_S1 = UART0_S1_OR_MASK;
+	}
+	
+	/* The line went idle: the bytes received since the last idle line form a frame */
+	if(status & UART0_S1_IDLE_MASK)
+	{
+		UART0_S1 = UART0_S1_IDLE_MASK;
+		length = rxFrameLength;
+		rxFrameLength = 0;
+		if((length != 0) && (rxFrameCallback))
+		{
+			rxFrameCallback(length);
+		}
+	}
 }
- 
@@ -0,0 +1,285 @@
+/***************************************************************************
+ *
+ *	Filename: 		MKL25Z4.h
+ *  Description:  	host stand-in for the KL25Z device header. Only the
+ *                  registers and core intrinsics used by the modules
+ *                  under test are provided. Peripheral registers are
+ *                  plain memory; host_model.c plays the DMA and the
+ *                  UART0 transmitter against them.
+ *
+ *****************************************************************************/
+#ifndef __HOST_MKL25Z4_H__
+#define __HOST_MKL25Z4_H__
+
+#include <stdint.h>
+
+#define __STATIC_INLINE		static inline
+
+/*********************************************************************************************************
+  Core
+*********************************************************************************************************/
+typedef enum IRQn
+{
+	DMA0_IRQn		=	0,
+	DMA1_IRQn		=	1,
+	DMA2_IRQn		=	2,
+	DMA3_IRQn		=	3,
+	UART0_IRQn		=	12,
+	ADC0_IRQn		=	15,
+	PIT_IRQn		=	22,
+	TSI0_IRQn		=	26,
+	LPTMR0_IRQn		=	28,
+	PORTD_IRQn		=	31
+}IRQn_Type;
+
+#define HOST_IRQ_CNT	(32U)
+
+extern volatile uint32_t hostPrimask;
+extern uint8_t hostNvicEnabled[HOST_IRQ_CNT];
+extern uint8_t hostNvicPriority[HOST_IRQ_CNT];
+
+/* Unmasking lets pending peripheral interrupts run, see host_Service */
+void host_Service(void);
+
+__STATIC_INLINE void __disable_irq(void)
+{
+	hostPrimask = 1U;
+}
+
+__STATIC_INLINE void __enable_irq(void)
+{
+	hostPrimask = 0U;
+	host_Service();
+}
+
+__STATIC_INLINE uint32_t __get_PRIMASK(void)
+{
+	return hostPrimask;
+}
+
+__STATIC_INLINE void __set_PRIMASK(uint32_t primask)
+{
+	hostPrimask = primask;
+	if(!primask)
+	{
+		host_Service();
+	}
+}
+
+__STATIC_INLINE void __DMB(void)
+{
+	__sync_synchronize();
+}
+
+__STATIC_INLINE uint32_t __REV(uint32_t value)
+{
+	return __builtin_bswap32(value);
+}
+
+__STATIC_INLINE uint32_t __REV16(uint32_t value)
+{
+	return ((value & 0xFF00FF00U) >> 8) | ((value & 0x00FF00FFU) << 8);
+}
+
+__STATIC_INLINE void NVIC_EnableIRQ(IRQn_Type irq)
+{
+	hostNvicEnabled[irq] = 1U;
+}
+
+__STATIC_INLINE void NVIC_DisableIRQ(IRQn_Type irq)
+{
+	hostNvicEnabled[irq] = 0U;
+}
+
+__STATIC_INLINE void NVIC_SetPriority(IRQn_Type irq, uint32_t priority)
+{
+	hostNvicPriority[irq] = (uint8_t)priority;
+}
+
+/* SysTick reads back a down-count derived from the host clock at the
+ * 48 MHz core rate, so only differences between reads are meaningful */
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t LOAD;
+	volatile uint32_t VAL;
+	volatile uint32_t CALIB;
+}SysTick_Type;
+
+SysTick_Type * host_SysTick(void);
+
+#define SysTick							(host_SysTick())
+#define SysTick_CTRL_ENABLE_Msk			(1UL << 0)
+#define SysTick_CTRL_TICKINT_Msk		(1UL << 1)
+#define SysTick_CTRL_CLKSOURCE_Msk		(1UL << 2)
+#define SysTick_CTRL_COUNTFLAG_Msk		(1UL << 16)
+#define SysTick_LOAD_RELOAD_Msk			(0xFFFFFFUL)
+#define SysTick_VAL_CURRENT_Msk			(0xFFFFFFUL)
+
+/*********************************************************************************************************
+  SIM, PORT, PMC
+*********************************************************************************************************/
+typedef struct
+{
+	volatile uint32_t SOPT2;
+	volatile uint32_t SOPT7;
+	volatile uint32_t SCGC4;
+	volatile uint32_t SCGC6;
+	volatile uint32_t SCGC7;
+}HOST_SIM_Type;
+
+extern HOST_SIM_Type hostSim;
+
+#define SIM_SOPT2						(hostSim.SOPT2)
+#define SIM_SOPT7						(hostSim.SOPT7)
+#define SIM_SCGC4						(hostSim.SCGC4)
+#define SIM_SCGC6						(hostSim.SCGC6)
+#define SIM_SCGC7						(hostSim.SCGC7)
+#define SIM_SOPT2_PLLFLLSEL_MASK		(0x10000U)
+#define SIM_SOPT2_UART0SRC(x)			(((uint32_t)(x) << 26) & 0xC000000U)
+#define SIM_SCGC4_UART0_MASK			(0x400U)
+#define SIM_SCGC6_DMAMUX_MASK			(0x2U)
+#define SIM_SCGC6_ADC0_MASK				(0x8000000U)
+#define SIM_SCGC7_DMA_MASK				(0x100U)
+
+extern volatile uint32_t hostPortaPcr[32];
+
+#define PORTA_PCR1						(hostPortaPcr[1])
+#define PORTA_PCR2						(hostPortaPcr[2])
+#define PORT_PCR_MUX(x)					(((uint32_t)(x) << 8) & 0x700U)
+
+extern volatile uint8_t hostPmcRegsc;
+
+#define PMC_REGSC						(hostPmcRegsc)
+#define PMC_REGSC_BGBE(x)				((uint8_t)(((uint8_t)(x) << 0) & 0x1U))
+#define PMC_REGSC_BGEN(x)				((uint8_t)(((uint8_t)(x) << 4) & 0x10U))
+
+/*********************************************************************************************************
+  DMA and DMAMUX
+*********************************************************************************************************/
+typedef struct
+{
+	volatile uint32_t SAR;
+	volatile uint32_t DAR;
+	volatile uint32_t DSR_BCR;
+	volatile uint32_t DCR;
+}HOST_DMA_Channel_t;
+
+extern HOST_DMA_Channel_t hostDma[4];
+extern volatile uint8_t hostDmamuxChcfg[4];
+
+#define DMA_BASE_PTR					(hostDma)
+#define DMA_SAR_REG(base, ch)			((base)[ch].SAR)
+#define DMA_DAR_REG(base, ch)			((base)[ch].DAR)
+#define DMA_DSR_BCR_REG(base, ch)		((base)[ch].DSR_BCR)
+#define DMA_DCR_REG(base, ch)			((base)[ch].DCR)
+
+#define DMA_DSR_BCR_BCR_MASK			(0xFFFFFFU)
+#define DMA_DSR_BCR_BCR(x)				((uint32_t)(x) & DMA_DSR_BCR_BCR_MASK)
+#define DMA_DSR_BCR_DONE_MASK			(0x1000000U)
+#define DMA_DSR_BCR_BSY_MASK			(0x2000000U)
+#define DMA_DSR_BCR_REQ_MASK			(0x4000000U)
+#define DMA_DSR_BCR_BED_MASK			(0x10000000U)
+#define DMA_DSR_BCR_BES_MASK			(0x20000000U)
+#define DMA_DSR_BCR_CE_MASK				(0x40000000U)
+
+#define DMA_DCR_START_MASK				(0x10000U)
+#define DMA_DCR_DSIZE_MASK				(0x60000U)
+#define DMA_DCR_DSIZE(x)				(((uint32_t)(x) << 17) & DMA_DCR_DSIZE_MASK)
+#define DMA_DCR_DINC_MASK				(0x80000U)
+#define DMA_DCR_SSIZE_MASK				(0x300000U)
+#define DMA_DCR_SSIZE(x)				(((uint32_t)(x) << 20) & DMA_DCR_SSIZE_MASK)
+#define DMA_DCR_SINC_MASK				(0x400000U)
+#define DMA_DCR_AA_MASK					(0x10000000U)
+#define DMA_DCR_CS_MASK					(0x20000000U)
+#define DMA_DCR_ERQ_MASK				(0x40000000U)
+#define DMA_DCR_EINT_MASK				(0x80000000U)
+
+#define DMAMUX0_CHCFG(ch)				(hostDmamuxChcfg[ch])
+#define DMAMUX_CHCFG_SOURCE(x)			((uint8_t)((x) & 0x3FU))
+#define DMAMUX_CHCFG_ENBL_MASK			(0x80U)
+
+/*********************************************************************************************************
+  UART0
+*********************************************************************************************************/
+typedef struct
+{
+	volatile uint8_t BDH;
+	volatile uint8_t BDL;
+	volatile uint8_t C1;
+	volatile uint8_t C2;
+	volatile uint8_t S1;
+	volatile uint8_t D;
+	volatile uint8_t C4;
+	volatile uint8_t C5;
+}HOST_UART0_Type;
+
+extern HOST_UART0_Type hostUart0;
+
+#define UART0_BDH						(hostUart0.BDH)
+#define UART0_BDL						(hostUart0.BDL)
+#define UART0_C1						(hostUart0.C1)
+#define UART0_C2						(hostUart0.C2)
+#define UART0_S1						(hostUart0.S1)
+#define UART0_D							(hostUart0.D)
+#define UART0_C4						(hostUart0.C4)
+#define UART0_C5						(hostUart0.C5)
+
+#define UART0_BDH_SBNS_MASK				(0x20U)
+#define UART0_BDH_SBNS_SHIFT			(5U)
+#define UART0_BDL_SBR_MASK				(0xFFU)
+#define UART0_C1_PT_MASK				(0x1U)
+#define UART0_C1_PT_SHIFT				(0U)
+#define UART0_C1_PE_MASK				(0x2U)
+#define UART0_C1_PE_SHIFT				(1U)
+#define UART0_C1_ILT_MASK				(0x4U)
+#define UART0_C1_M_MASK					(0x10U)
+#define UART0_C1_M_SHIFT				(4U)
+#define UART0_C2_RE_MASK				(0x4U)
+#define UART0_C2_RE_SHIFT				(2U)
+#define UART0_C2_TE_MASK				(0x8U)
+#define UART0_C2_TE_SHIFT				(3U)
+#define UART0_C2_ILIE_MASK				(0x10U)
+#define UART0_C2_RIE_MASK				(0x20U)
+#define UART0_C2_TCIE_MASK				(0x40U)
+#define UART0_C2_TIE_MASK				(0x80U)
+#define UART0_S1_OR_MASK				(0x8U)
+#define UART0_S1_IDLE_MASK				(0x10U)
+#define UART0_S1_RDRF_MASK				(0x20U)
+#define UART0_S1_TDRE_MASK				(0x80U)
+#define UART0_C4_M10_MASK				(0x20U)
+#define UART0_C5_RDMAE_MASK				(0x20U)
+#define UART0_C5_TDMAE_MASK				(0x80U)
+
+/*********************************************************************************************************
+  ADC0
+*********************************************************************************************************/
+typedef struct
+{
+	volatile uint32_t SC1A;
+	volatile uint32_t SC2;
+	volatile uint32_t SC3;
+	volatile uint32_t RA;
+	volatile uint32_t PG;
+	volatile uint32_t MG;
+}HOST_ADC0_Type;
+
+extern HOST_ADC0_Type hostAdc0;
+
+#define ADC0_SC1A						(hostAdc0.SC1A)
+#define ADC0_SC2						(hostAdc0.SC2)
+#define ADC0_SC3						(hostAdc0.SC3)
+#define ADC0_RA							(hostAdc0.RA)
+#define ADC0_PG							(hostAdc0.PG)
+#define ADC0_MG							(hostAdc0.MG)
+
+#define ADC_SC1_COCO_MASK				(0x80U)
+#define ADC_SC2_DMAEN_MASK				(0x4U)
+#define ADC_SC2_ADTRG_MASK				(0x40U)
+#define ADC_SC2_ADACT_MASK				(0x80U)
+#define ADC_SC3_ADCO_MASK				(0x8U)
+#define ADC_SC3_CALF_MASK				(0x40U)
+#define ADC_SC3_CAL_MASK				(0x80U)
+#define ADC_SC3_CAL_SHIFT				(7U)
+
+#endif /* __HOST_MKL25Z4_H__ */
@@ -0,0 +1,240 @@
+/***************************************************************************
+ *
+ *	Filename: 		host_model.c
+ *  Description:  	host model of the KL25Z core and peripherals used
+ *                  by the host tests. Registers are plain memory;
+ *                  interrupts are delivered by host_Service whenever
+ *                  the firmware unmasks them.
+ *
+ *****************************************************************************/
+
+#include "includes.h"
+#include <time.h>
+
+#define HOST_CORE_CLOCK_HZ		(48000000ULL)
+
+volatile uint32_t hostPrimask;
+uint8_t hostNvicEnabled[HOST_IRQ_CNT];
+uint8_t hostNvicPriority[HOST_IRQ_CNT];
+
+HOST_SIM_Type hostSim;
+volatile uint32_t hostPortaPcr[32];
+volatile uint8_t hostPmcRegsc;
+HOST_DMA_Channel_t hostDma[4];
+volatile uint8_t hostDmamuxChcfg[4];
+HOST_UART0_Type hostUart0;
+HOST_ADC0_Type hostAdc0;
+
+static SysTick_Type hostSysTickRegs;
+static uint64_t hostSysTickStartNs;
+static uint32_t hostMsec;
+
+uint64_t host_NowNs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Down-counter running at the core clock while ENABLE is set */
+SysTick_Type * host_SysTick(void)
+{
+	uint64_t ticks;
+	uint32_t reload = hostSysTickRegs.LOAD & SysTick_LOAD_RELOAD_Msk;
+
+	if(hostSysTickRegs.CTRL & SysTick_CTRL_ENABLE_Msk)
+	{
+		if(!hostSysTickStartNs)
+		{
+			hostSysTickStartNs = host_NowNs();
+		}
+		ticks = (host_NowNs() - hostSysTickStartNs) * HOST_CORE_CLOCK_HZ / 1000000000ULL;
+		hostSysTickRegs.VAL = reload - (uint32_t)(ticks % ((uint64_t)reload + 1U));
+	}
+	else
+	{
+		hostSysTickStartNs = 0;
+	}
+	return &hostSysTickRegs;
+}
+
+/* Weak so tests that don't link dma.c still build */
+void DMA0_IRQHandler(void) __attribute__((weak));
+void DMA1_IRQHandler(void) __attribute__((weak));
+void DMA2_IRQHandler(void) __attribute__((weak));
+void DMA3_IRQHandler(void) __attribute__((weak));
+
+static void (* const hostDmaIsr[4])(void) =
+{
+	DMA0_IRQHandler, DMA1_IRQHandler, DMA2_IRQHandler, DMA3_IRQHandler
+};
+
+static uint8_t hostWire[HOST_WIRE_SIZE];
+static uint32_t hostWireLength;
+static uint32_t hostUartBudget = HOST_UART_UNLIMITED;
+static bool hostServicing;
+
+/* Transfer size in bytes of an SSIZE/DSIZE field */
+static uint32_t host_DmaSize(uint32_t field)
+{
+	return (field == 0U) ? 4U : ((field == 2U) ? 2U : 1U);
+}
+
+/* Run a software-started memory-to-memory block to the end */
+static void host_DmaBlock(HOST_DMA_Channel_t *ch)
+{
+	uint32_t dcr = ch->DCR;
+	uint32_t ssize = host_DmaSize((dcr & DMA_DCR_SSIZE_MASK) >> 20);
+	uint32_t dsize = host_DmaSize((dcr & DMA_DCR_DSIZE_MASK) >> 17);
+	uint8_t *src = (uint8_t *)(uintptr_t)ch->SAR;
+	uint8_t *dst = (uint8_t *)(uintptr_t)ch->DAR;
+	uint32_t bcr = ch->DSR_BCR & DMA_DSR_BCR_BCR_MASK;
+	uint32_t word = 0;
+
+	assert(ssize == dsize);
+	while(bcr >= dsize)
+	{
+		memcpy(&word, src, ssize);
+		memcpy(dst, &word, dsize);
+		if(dcr & DMA_DCR_SINC_MASK)
+		{
+			src += ssize;
+		}
+		if(dcr & DMA_DCR_DINC_MASK)
+		{
+			dst += dsize;
+		}
+		bcr -= dsize;
+	}
+	if(bcr != 0)		// A length the size doesn't divide is a configuration error
+	{
+		ch->DSR_BCR |= DMA_DSR_BCR_CE_MASK;
+	}
+	ch->SAR = (uint32_t)(uintptr_t)src;
+	ch->DAR = (uint32_t)(uintptr_t)dst;
+	ch->DCR &= ~DMA_DCR_START_MASK;
+	ch->DSR_BCR = (ch->DSR_BCR & DMA_DSR_BCR_CE_MASK) | DMA_DSR_BCR_DONE_MASK | bcr;
+}
+
+/* Feed the UART0 transmitter from a channel on its DMA request */
+static bool host_DmaUartTx(uint8_t chn)
+{
+	HOST_DMA_Channel_t *ch = &hostDma[chn];
+	uint8_t *src = (uint8_t *)(uintptr_t)ch->SAR;
+	uint32_t bcr = ch->DSR_BCR & DMA_DSR_BCR_BCR_MASK;
+	uint32_t moved = 0;
+
+	if((!(ch->DCR & DMA_DCR_ERQ_MASK)) || (!(hostDmamuxChcfg[chn] & DMAMUX_CHCFG_ENBL_MASK)) ||
+	   ((hostDmamuxChcfg[chn] & 0x3FU) != UART0_TX_DMA_SOURCE) ||
+	   (!(hostUart0.C5 & UART0_C5_TDMAE_MASK)) || (!(hostUart0.C2 & UART0_C2_TE_MASK)) || (bcr == 0))
+	{
+		return false;
+	}
+	assert(ch->DAR == (uint32_t)(uintptr_t)&hostUart0.D);
+	while((bcr != 0) && (moved < hostUartBudget))
+	{
+		assert(hostWireLength < HOST_WIRE_SIZE);
+		hostWire[hostWireLength++] = *src;
+		if(ch->DCR & DMA_DCR_SINC_MASK)
+		{
+			src++;
+		}
+		bcr--;
+		moved++;
+	}
+	ch->SAR = (uint32_t)(uintptr_t)src;
+	ch->DSR_BCR = (ch->DSR_BCR & ~DMA_DSR_BCR_BCR_MASK) | bcr;
+	if(bcr == 0)
+	{
+		ch->DSR_BCR |= DMA_DSR_BCR_DONE_MASK;
+	}
+	return moved != 0;
+}
+
+/* Deliver a pending channel interrupt; DONE left set by the ISR with
+ * nothing restarted is cleared, as the write-1-to-clear would have */
+static bool host_DmaInterrupt(uint8_t chn)
+{
+	HOST_DMA_Channel_t *ch = &hostDma[chn];
+
+	if((!(ch->DSR_BCR & DMA_DSR_BCR_DONE_MASK)) || (!(ch->DCR & DMA_DCR_EINT_MASK)) ||
+	   (!hostNvicEnabled[DMA0_IRQn + chn]) || (hostPrimask) || (!hostDmaIsr[chn]))
+	{
+		return false;
+	}
+	hostDmaIsr[chn]();
+	if((ch->DSR_BCR & DMA_DSR_BCR_DONE_MASK) && (!(ch->DSR_BCR & DMA_DSR_BCR_BCR_MASK)))
+	{
+		ch->DSR_BCR = 0;
+	}
+	return true;
+}
+
+void host_Service(void)
+{
+	bool progress;
+	uint8_t chn;
+
+	/* ISRs unmask too; what they start is picked up by the outer loop */
+	if(hostServicing)
+	{
+		return;
+	}
+	hostServicing = true;
+	do
+	{
+		progress = false;
+		for(chn = 0; chn < 4U; chn++)
+		{
+			if(hostDma[chn].DCR & DMA_DCR_START_MASK)
+			{
+				host_DmaBlock(&hostDma[chn]);
+				progress = true;
+			}
+			progress |= host_DmaUartTx(chn);
+			progress |= host_DmaInterrupt(chn);
+		}
+	}while(progress && (hostUartBudget == HOST_UART_UNLIMITED));
+	hostServicing = false;
+}
+
+uint32_t host_UartWire(const uint8_t **data)
+{
+	if(data)
+	{
+		*data = hostWire;
+	}
+	return hostWireLength;
+}
+
+void host_SetUartBudget(uint32_t bytes)
+{
+	hostUartBudget = bytes;
+}
+
+/* Every read moves time on by a millisecond so timeouts expire */
+uint32_t LPTMR_Hal_GetCounterValue(void)
+{
+	host_Service();
+	return hostMsec++;
+}
+
+void host_Reset(void)
+{
+	hostPrimask = 0;
+	memset(hostNvicEnabled, 0, sizeof(hostNvicEnabled));
+	memset(hostNvicPriority, 0, sizeof(hostNvicPriority));
+	memset(&hostSim, 0, sizeof(hostSim));
+	memset((void *)hostPortaPcr, 0, sizeof(hostPortaPcr));
+	hostPmcRegsc = 0;
+	memset(hostDma, 0, sizeof(hostDma));
+	memset((void *)hostDmamuxChcfg, 0, sizeof(hostDmamuxChcfg));
+	memset(&hostUart0, 0, sizeof(hostUart0));
+	memset(&hostAdc0, 0, sizeof(hostAdc0));
+	memset(&hostSysTickRegs, 0, sizeof(hostSysTickRegs));
+	hostSysTickStartNs = 0;
+	hostMsec = 0;
+	hostWireLength = 0;
+	hostUartBudget = HOST_UART_UNLIMITED;
+}
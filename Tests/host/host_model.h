@@ -0,0 +1,65 @@
+/***************************************************************************
+ *
+ *	Filename: 		host_model.h
+ *  Description:  	host model of the KL25Z core and peripherals used
+ *                  by the host tests
+ *
+ *****************************************************************************/
+#ifndef __HOST_MODEL_H__
+#define __HOST_MODEL_H__
+
+#include <stdint.h>
+
+#define HOST_WIRE_SIZE			(1024U * 1024U)		// Bytes the UART0 transmitter can capture
+#define HOST_UART_UNLIMITED		(0xFFFFFFFFU)
+
+/* Stands in for lptmr_hal.h, SYS_TimeGetMsec reads it */
+uint32_t LPTMR_Hal_GetCounterValue(void);
+
+/****************************************************
+* @name: host_Reset
+*
+* @description: clear every register, the interrupt mask and the
+*               simulated millisecond clock
+*/
+void host_Reset(void);
+
+/****************************************************
+* @name: host_NowNs
+*
+* @description: host monotonic clock in nanoseconds, for benchmarks
+*/
+uint64_t host_NowNs(void);
+
+/****************************************************
+* @name: host_Service
+*
+* @description: let the peripherals run. Started memory DMA blocks
+*               finish, channels on the UART0 TX request move bytes to
+*               the wire, and DONE channels get their ISR if the IRQ is
+*               enabled and not masked. Called whenever PRIMASK is
+*               cleared and on every millisecond clock read.
+*/
+void host_Service(void);
+
+/****************************************************
+* @name: host_UartWire
+*
+* @description: bytes the UART0 transmitter has sent since host_Reset
+*
+* @param: data -- location that will point to the captured bytes
+*
+* @return: number of bytes sent
+*/
+uint32_t host_UartWire(const uint8_t **data);
+
+/****************************************************
+* @name: host_SetUartBudget
+*
+* @description: limit the bytes the transmitter takes per host_Service
+*               call, so a DMA span can still be in flight when the
+*               firmware runs again. HOST_UART_UNLIMITED drains at once.
+*/
+void host_SetUartBudget(uint32_t bytes);
+
+#endif /* __HOST_MODEL_H__ */
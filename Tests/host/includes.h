@@ -0,0 +1,60 @@
+/***************************************************************************
+ *
+ *	Filename: 		includes.h
+ *  Description:  	host build replacement of Include/includes.h. It
+ *                  shares the include guard, so the "includes.h" that
+ *                  the repo headers pull in becomes a no-op once this
+ *                  one has been read first through -I Tests/host.
+ *
+ *****************************************************************************/
+
+#ifndef  __INCLUDES_H
+#define  __INCLUDES_H
+
+/*********************************************************************************************************
+  Standard header files
+*********************************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <assert.h>
+
+/*********************************************************************************************************
+  Common header files
+*********************************************************************************************************/
+#include "MKL25Z4.h"
+
+/*********************************************************************************************************
+  Driver header files, only those of the modules built for the host
+*********************************************************************************************************/
+#include "system.h"
+#include "flash.h"
+#include "adc16_hal.h"
+#include "adc_driver.h"
+#include "adc.h"
+#include "task.h"
+#include "uart.h"
+
+/*********************************************************************************************************
+  User's header files
+*********************************************************************************************************/
+#include "memory.h"
+#include "dma.h"
+#include "circbuf.h"
+#include "data.h"
+#include "log.h"
+#include "decimator.h"
+
+/*********************************************************************************************************
+  Host model, see host_model.c
+*********************************************************************************************************/
+#include "host_model.h"
+
+#endif
+
+/*********************************************************************************************************
+  END FILE
+*********************************************************************************************************/
@@ -0,0 +1,182 @@
+/***************************************************************************
+ *
+ *	Filename: 		test_adc_cal.c
+ *  Description:  	host test of the ADC calibration record on the RAM
+ *                  stand-in flash: boot calibrates and saves once, the
+ *                  next boot restores the record, and a corrupt, stale
+ *                  or unsaved record is handled. The ADC driver is
+ *                  stubbed here.
+ *
+ *****************************************************************************/
+
+#include "includes.h"
+
+#define TEST_BANDGAP		(19859)		// Bandgap code at VDD = 3.3 V
+#define TEST_GAIN			(0x8123U)	// Gain the self-calibration comes up with
+
+/* Globals of adc.c that no header exports */
+extern uint32_t adcrTemp25;
+extern uint32_t adcr100m;
+
+static uint32_t calibrations;			// ADC_GetCalibrationParam calls
+static uint16_t gainSet;				// Last ADC_SetCalibrationParam
+static bool longSample;					// Changes the default configuration
+static bool eraseFails;
+static int32_t lastEvent = -1;
+static int32_t lastEventArg;
+
+/* ADC driver stand-ins, just enough for adc.c */
+adc16_Status_t ADC_ConfigDefaultMode(adc16_Conv_Config_t *userConfigPtr)
+{
+	memset(userConfigPtr, 0, sizeof(*userConfigPtr));
+	userConfigPtr->resolution = adc16_ResolutionOf16;
+	userConfigPtr->longSampleEnable = longSample;
+	return status_ADC16_Success;
+}
+
+adc16_Status_t ADC_Init(const adc16_Conv_Config_t *userConfigPtr)
+{
+	return status_ADC16_Success;
+}
+
+adc16_Status_t ADC_GetCalibrationParam(adc_calibration_param_t *paramPtr)
+{
+	calibrations++;
+	paramPtr->plusSideGainValue = TEST_GAIN;
+	return status_ADC16_Success;
+}
+
+adc16_Status_t ADC_SetCalibrationParam(adc_calibration_param_t *paramPtr)
+{
+	gainSet = paramPtr->plusSideGainValue;
+	return status_ADC16_Success;
+}
+
+adc16_Status_t ADC_ConfigCh(adc16_Ch_Config_t *configPtr)
+{
+	assert(configPtr->ch_Idx == adc16_Bandgap);
+	return status_ADC16_Success;
+}
+
+void ADC_WaitForConvComplete(void)
+{}
+
+int16_t ADC_GetConvValueSigned(void)
+{
+	return TEST_BANDGAP;
+}
+
+void ADC_PauseConv(void)
+{}
+
+adc16_Status_t ADC_StartMonitor(adc16_Ch_t ch, const adc16_Hw_Cmp_Config_t *cmpConfigPtr,
+								adc_hw_trigger_t trigger, uint32_t periodUs, adc_conv_callback_t callback)
+{
+	return status_ADC16_Success;
+}
+
+/* The test builds adc.c with warnings enabled for MOD_ADC, log.c isn't linked */
+void log_Event1(uint8_t evtId, int32_t arg)
+{
+	lastEvent = evtId;
+	lastEventArg = arg;
+}
+
+flash_status_t __real_flash_EraseSector(uint32_t addr);
+
+/* Linked with --wrap to make the save fail on demand */
+flash_status_t __wrap_flash_EraseSector(uint32_t addr)
+{
+	return eraseFails ? status_FLASH_AccessError : __real_flash_EraseSector(addr);
+}
+
+/* A cold boot: the RAM copies are lost, the flash keeps the record */
+static void test_Boot(void)
+{
+	adcrTemp25 = 0;
+	adcr100m = 0;
+	gainSet = 0;
+	calibrations = 0;
+	lastEvent = -1;
+	app_ADCInit();
+	assert(gainSet == TEST_GAIN);
+	assert(adcrTemp25 == ADCR_VDD * V_TEMP25 / 3300U);
+	assert(adcr100m == ADCR_VDD * 100U / 3300U);
+	/* The table answers 25 oC at the calibrated code */
+	assert(abs(temp_ConvertRaw(adcrTemp25) - STANDARD_TEMP * 100) <= 1);
+}
+
+static void test_Record(void)
+{
+	adc_cal_record_t record;
+
+	assert(flash_EraseSector(ADC_CAL_FLASH_ADDR) == status_FLASH_Success);
+
+	/* Nothing saved yet: calibrate and save */
+	test_Boot();
+	assert(calibrations == 1U);
+	assert(lastEvent == -1);
+	assert(flash_Read(ADC_CAL_FLASH_ADDR, &record, sizeof(record)) == status_FLASH_Success);
+	assert(record.magic == ADC_CAL_MAGIC);
+	assert(record.version == ADC_CAL_RECORD_VERSION);
+	assert(record.plusSideGainValue == TEST_GAIN);
+	assert(record.adcrTemp25 == adcrTemp25);
+
+	/* The next boot restores it without calibrating */
+	test_Boot();
+	assert(calibrations == 0U);
+
+	/* A flipped bit fails the CRC */
+	record.adcr100m ^= 0x10U;
+	assert(flash_EraseSector(ADC_CAL_FLASH_ADDR) == status_FLASH_Success);
+	assert(flash_Program(ADC_CAL_FLASH_ADDR, (const uint32_t *)&record, sizeof(record) / 4U) == status_FLASH_Success);
+	test_Boot();
+	assert(calibrations == 1U);
+	test_Boot();
+	assert(calibrations == 0U);
+
+	/* A record of a different converter setup is stale */
+	longSample = true;
+	test_Boot();
+	assert(calibrations == 1U);
+	test_Boot();
+	assert(calibrations == 0U);
+
+	/* A failed save is reported as an event with the flash status */
+	assert(flash_EraseSector(ADC_CAL_FLASH_ADDR) == status_FLASH_Success);
+	eraseFails = true;
+	test_Boot();
+	assert(calibrations == 1U);
+	assert(lastEvent == TEMP_CALIBRATION_NOT_SAVED);
+	assert(lastEventArg == status_FLASH_AccessError);
+	eraseFails = false;
+	test_Boot();
+	assert(calibrations == 1U);
+	assert(lastEvent == -1);
+}
+
+/* The stand-in keeps the erase and program rules of the flash */
+static void test_StandIn(void)
+{
+	uint32_t word = 0x12345678U;
+
+	assert(flash_EraseSector(ADC_CAL_FLASH_ADDR + 4U) == status_FLASH_InvalidArgument);
+	assert(flash_EraseSector(ADC_CAL_FLASH_ADDR + FLASH_SECTOR_SIZE) == status_FLASH_InvalidArgument);
+	assert(flash_Program(ADC_CAL_FLASH_ADDR + 2U, &word, 1) == status_FLASH_InvalidArgument);
+	assert(flash_EraseSector(ADC_CAL_FLASH_ADDR) == status_FLASH_Success);
+	assert(flash_Program(ADC_CAL_FLASH_ADDR + 8U, &word, 1) == status_FLASH_Success);
+	assert(flash_Program(ADC_CAL_FLASH_ADDR + 8U, &word, 1) == status_FLASH_VerifyError);
+	word = 0;
+	assert(flash_Read(ADC_CAL_FLASH_ADDR + 8U, &word, 4) == status_FLASH_Success);
+	assert(word == 0x12345678U);
+	assert(flash_Read(ADC_CAL_FLASH_ADDR + FLASH_SECTOR_SIZE - 2U, &word, 4) == status_FLASH_InvalidArgument);
+}
+
+int main(void)
+{
+	host_Reset();
+	test_StandIn();
+	test_Record();
+	printf("test_adc_cal passed\n");
+	return 0;
+}
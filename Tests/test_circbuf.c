@@ -0,0 +1,114 @@
+/***************************************************************************
+ *
+ *	Filename: 		test_circbuf.c
+ *  Description:  	host test of the circular buffer, and a benchmark of
+ *                  byte-wise against bulk enqueue/dequeue
+ *
+ *****************************************************************************/
+
+#include "includes.h"
+
+#define BENCH_RING_SIZE		(256U)		// UART0_TX_BUF_SIZE
+#define BENCH_CHUNK			(24U)		// About one formatted log line
+#define BENCH_BYTES			(16U * 1024U * 1024U)
+
+static void test_Limits(void)
+{
+	CircBuf_t cb;
+
+	assert(cb_Init(&cb, 0) == NULL);
+	assert(cb_Init(NULL, 16) == NULL);
+	/* Sizes that can't be rounded up to a power of two in 32 bits */
+	assert(cb_Init(&cb, CB_MAX_ITEMS + 1U) == NULL);
+	assert(cb_Init(&cb, 0xFFFFFFFFU) == NULL);
+
+	assert(cb_Init(&cb, 1) == &cb);
+	assert(cb.size == 1);
+	assert(cb_Enqueue(&cb, 0x5A) == NORMAL);
+	assert(cb_IsFull(&cb) == FULL);
+	assert(cb_Destroy(&cb) == FREE_SUCCESS);
+}
+
+/* Indices are free running, so they must survive wrapping past 2^32 */
+static void test_IndexWrap(void)
+{
+	CircBuf_t cb;
+	uint8_t in[10], out[10];
+	uint32_t i;
+
+	for(i = 0; i < sizeof(in); i++)
+		in[i] = (uint8_t)(0xC0 + i);
+	assert(cb_Init(&cb, 16) == &cb);
+	cb.head = cb.tail = 0xFFFFFFFAU;
+	assert(cb_EnqueueBulk(&cb, in, sizeof(in)) == sizeof(in));
+	assert(cb_Length(&cb) == sizeof(in));
+	assert(cb_DequeueBulk(&cb, out, sizeof(out)) == sizeof(out));
+	assert(memcmp(in, out, sizeof(in)) == 0);
+	assert(cb_IsEmpty(&cb) == EMPTY);
+	cb_Destroy(&cb);
+}
+
+static double bench_Bytewise(CircBuf_t *cb, const uint8_t *chunk, uint8_t *out)
+{
+	uint64_t start = host_NowNs();
+	uint32_t done, i;
+
+	for(done = 0; done < BENCH_BYTES; done += BENCH_CHUNK)
+	{
+		for(i = 0; i < BENCH_CHUNK; i++)
+			cb_Enqueue(cb, chunk[i]);
+		for(i = 0; i < BENCH_CHUNK; i++)
+			cb_Dequeue(cb, &out[i]);
+	}
+	return (double)(host_NowNs() - start);
+}
+
+static double bench_Bulk(CircBuf_t *cb, const uint8_t *chunk, uint8_t *out)
+{
+	uint64_t start = host_NowNs();
+	uint32_t done;
+
+	for(done = 0; done < BENCH_BYTES; done += BENCH_CHUNK)
+	{
+		cb_EnqueueBulk(cb, chunk, BENCH_CHUNK);
+		cb_DequeueBulk(cb, out, BENCH_CHUNK);
+	}
+	return (double)(host_NowNs() - start);
+}
+
+static void bench_Throughput(void)
+{
+	CircBuf_t cb;
+	uint8_t chunk[BENCH_CHUNK], out[BENCH_CHUNK];
+	volatile uint8_t sink = 0;
+	double byteNs, bulkNs;
+	uint32_t i;
+
+	for(i = 0; i < BENCH_CHUNK; i++)
+		chunk[i] = (uint8_t)('A' + i);
+	assert(cb_Init(&cb, BENCH_RING_SIZE) == &cb);
+
+	/* The chunk size doesn't divide the ring, so copies hit every wrap */
+	byteNs = bench_Bytewise(&cb, chunk, out);
+	assert(memcmp(chunk, out, BENCH_CHUNK) == 0);
+	bulkNs = bench_Bulk(&cb, chunk, out);
+	assert(memcmp(chunk, out, BENCH_CHUNK) == 0);
+	sink = out[0];
+	(void)sink;
+
+	printf("circbuf %u-byte chunks through a %u-byte ring:\n", BENCH_CHUNK, BENCH_RING_SIZE);
+	printf("  byte-wise  %8.1f MB/s\n", BENCH_BYTES / byteNs * 1000.0);
+	printf("  bulk       %8.1f MB/s  (%.1fx)\n", BENCH_BYTES / bulkNs * 1000.0, byteNs / bulkNs);
+	cb_Destroy(&cb);
+}
+
+int main(void)
+{
+	host_Reset();
+	circBuf_UnitTest();
+	test_Limits();
+	test_IndexWrap();
+	bench_Throughput();
+	printf("test_circbuf passed\n");
+	return 0;
+}
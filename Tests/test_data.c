@@ -0,0 +1,166 @@
+/***************************************************************************
+ *
+ *	Filename: 		test_data.c
+ *  Description:  	host test of data_Div100 over every 32-bit value, of
+ *                  my_itoa and my_atoi against snprintf and strtol, and
+ *                  a benchmark of both. data.c is included to reach its
+ *                  static helpers.
+ *
+ *****************************************************************************/
+
+#include "../Src/data.c"
+
+#define TEST_NEAR_ZERO		(100000)	// Every value within this of zero
+#define TEST_STRIDE			(997U)		// Then one value in this many
+#define BENCH_CALLS			(4000000U)
+
+/* Static and padded, my_atoi reads whole aligned words */
+static uint8_t str[64];
+static uint8_t ref[64];
+
+static void test_Div100(void)
+{
+	uint32_t num = 0;
+
+	do{
+		if(data_Div100(num) != num / 100U)
+		{
+			printf("data_Div100(%u) = %u\n", num, data_Div100(num));
+			exit(1);
+		}
+	}while(++num != 0U);
+}
+
+static void test_Itoa(int32_t value)
+{
+	static const int32_t bases[] = {2, 8, 16, 32};
+	char expect[40];
+	uint32_t i, num, base;
+	char *p;
+
+	my_itoa(str, value, 10);
+	snprintf(expect, sizeof(expect), "%d", value);
+	if(strcmp((char *)str, expect) != 0)
+	{
+		printf("my_itoa(%d, 10) = \"%s\"\n", value, str);
+		exit(1);
+	}
+	my_itoa(str, value, 16);
+	snprintf(expect, sizeof(expect), "%X", (uint32_t)value);
+	assert(strcmp((char *)str, expect) == 0);
+	/* The other bases against a plain division loop */
+	for(i = 0; i < sizeof(bases) / sizeof(bases[0]) + 2U; i++)
+	{
+		base = (i < sizeof(bases) / sizeof(bases[0])) ? (uint32_t)bases[i] : ((i & 1U) ? 7U : 36U);
+		num = (uint32_t)value;
+		p = expect + sizeof(expect) - 1U;
+		*p = '\0';
+		do{
+			*--p = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"[num % base];
+			num /= base;
+		}while(num);
+		my_itoa(str, value, (int32_t)base);
+		assert(strcmp((char *)str, p) == 0);
+	}
+}
+
+static void test_Atoi(int32_t value)
+{
+	static const char *const prefix[] = {"", " ", "\t+", "  \n", "+"};
+	uint32_t offset, i;
+	int len;
+
+	/* Every start alignment, with leading space, signs and trailing junk */
+	for(offset = 0; offset < 4U; offset++)
+	{
+		i = (offset + (uint32_t)value) % (sizeof(prefix) / sizeof(prefix[0]));
+		len = snprintf((char *)str + offset, sizeof(str) - offset, "%s%d%s", (value < 0) ? " " : prefix[i],
+					   value, (offset & 1U) ? "7x" : "");
+		memset(str + offset + len + 1, '5', sizeof(str) - offset - len - 1U);
+		if(my_atoi(str + offset) != (int32_t)strtol((char *)str + offset, NULL, 10))
+		{
+			printf("my_atoi(\"%s\") = %d\n", str + offset, my_atoi(str + offset));
+			exit(1);
+		}
+	}
+}
+
+static void test_Convert(void)
+{
+	int64_t value;
+
+	for(value = -TEST_NEAR_ZERO; value <= TEST_NEAR_ZERO; value++)
+	{
+		test_Itoa((int32_t)value);
+		test_Atoi((int32_t)value);
+	}
+	for(value = INT32_MIN; value <= INT32_MAX; value += TEST_STRIDE)
+	{
+		test_Itoa((int32_t)value);
+		test_Atoi((int32_t)value);
+	}
+	test_Itoa(INT32_MAX);
+	test_Atoi(INT32_MAX);
+	test_Itoa(INT32_MIN);
+	test_Atoi(INT32_MIN);
+	assert(my_atoi((uint8_t *)"") == 0);
+	assert(my_atoi((uint8_t *)"-") == 0);
+	assert(my_atoi(NULL) == 0);
+	assert(my_itoa(NULL, 1, 10) == NULL);
+	my_itoa(str, 5, 1);
+	assert(str[0] == '\0');
+}
+
+static void bench_Convert(void)
+{
+	uint64_t start, itoaNs, snprintfNs, atoiNs, strtolNs;
+	uint32_t i, sum = 0;
+
+	start = host_NowNs();
+	for(i = 0; i < BENCH_CALLS; i++)
+	{
+		my_itoa(str, (int32_t)(i * 2654435761U), 10);
+		sum += str[1];
+	}
+	itoaNs = host_NowNs() - start;
+	start = host_NowNs();
+	for(i = 0; i < BENCH_CALLS; i++)
+	{
+		snprintf((char *)ref, sizeof(ref), "%d", (int32_t)(i * 2654435761U));
+		sum += ref[1];
+	}
+	snprintfNs = host_NowNs() - start;
+	assert(strcmp((char *)str, (char *)ref) == 0);
+
+	start = host_NowNs();
+	for(i = 0; i < BENCH_CALLS; i++)
+	{
+		str[9] = (uint8_t)('0' + (i & 7U));
+		sum += (uint32_t)my_atoi(str);
+	}
+	atoiNs = host_NowNs() - start;
+	start = host_NowNs();
+	for(i = 0; i < BENCH_CALLS; i++)
+	{
+		str[9] = (uint8_t)('0' + (i & 7U));
+		sum += (uint32_t)strtol((char *)str, NULL, 10);
+	}
+	strtolNs = host_NowNs() - start;
+
+	printf("ns per call      ours  libc\n");
+	printf("  itoa base 10  %5.1f  %5.1f  (snprintf)\n", (double)itoaNs / BENCH_CALLS,
+		   (double)snprintfNs / BENCH_CALLS);
+	printf("  atoi          %5.1f  %5.1f  (strtol)\n", (double)atoiNs / BENCH_CALLS,
+		   (double)strtolNs / BENCH_CALLS);
+	printf("  (checksum %u)\n", sum);
+}
+
+int main(void)
+{
+	host_Reset();
+	test_Div100();
+	test_Convert();
+	bench_Convert();
+	printf("test_data passed\n");
+	return 0;
+}
@@ -0,0 +1,182 @@
+/***************************************************************************
+ *
+ *	Filename: 		test_decimator.c
+ *  Description:  	host test of the decimator on a noisy 12-bit ramp:
+ *                  bit-exact against a 64-bit reference CIC, the same
+ *                  in one call or split into blocks, and the error to
+ *                  the clean ramp falling with the ratio
+ *
+ *****************************************************************************/
+
+#include "includes.h"
+#include <math.h>
+
+#define TEST_IN_BITS		(12U)
+#define TEST_OUT_BITS		(16U)
+#define TEST_CHANNELS		(3U)		// Interleaved like an ADC_ScanStart block
+#define TEST_SAMPLES		(65536U)	// Per channel
+#define TEST_NOISE			(2)			// Uniform noise of +-TEST_NOISE LSB
+
+static uint16_t block[TEST_SAMPLES * TEST_CHANNELS];
+static uint32_t out[TEST_SAMPLES + 1U];
+static uint32_t split[TEST_SAMPLES + 1U];
+static uint32_t ref[TEST_SAMPLES + 1U];
+static uint32_t seed = 2016U;
+
+static uint32_t test_Rand(void)
+{
+	seed = seed * 1664525U + 1013904223U;
+	return seed >> 8;
+}
+
+/* The clean ramp in LSB, 100 to about 3900 over the block */
+static double test_Ramp(double t)
+{
+	return 100.0 + t * (3800.0 / TEST_SAMPLES);
+}
+
+/* Channel 1 carries the noisy ramp, the others are there to be skipped */
+static void test_Signal(void)
+{
+	uint32_t i;
+	int32_t noise;
+
+	for(i = 0; i < TEST_SAMPLES; i++)
+	{
+		noise = (int32_t)(test_Rand() % (2U * TEST_NOISE + 1U)) - TEST_NOISE;
+		block[i * TEST_CHANNELS] = 0x0FFFU;
+		block[i * TEST_CHANNELS + 1U] = (uint16_t)((int32_t)lround(test_Ramp(i)) + noise);
+		block[i * TEST_CHANNELS + 2U] = (uint16_t)(i & 0x0FFFU);
+	}
+}
+
+/* Straightforward CIC with 64-bit state that never wraps */
+static uint32_t test_Reference(uint32_t ratio, uint8_t stages, uint8_t outShift)
+{
+	int64_t integ[DEC_MAX_STAGES] = {0};
+	int64_t comb[DEC_MAX_STAGES] = {0};
+	int64_t y, prev;
+	uint32_t i, s, outCnt = 0;
+
+	for(i = 0; i < TEST_SAMPLES; i++)
+	{
+		y = block[i * TEST_CHANNELS + 1U];
+		for(s = 0; s < stages; s++)
+		{
+			integ[s] += y;
+			y = integ[s];
+		}
+		if((i + 1U) % ratio == 0U)
+		{
+			for(s = 0; s < stages; s++)
+			{
+				prev = comb[s];
+				comb[s] = y;
+				y -= prev;
+			}
+			assert((y >= 0) && (y <= (int64_t)UINT32_MAX));
+			ref[outCnt++] = (uint32_t)(y >> outShift);
+		}
+	}
+	return outCnt;
+}
+
+/* RMS error to the clean ramp at the centre of each output's window, in
+ * input LSB, skipping the outputs the combs need to fill */
+static double test_Rms(uint32_t ratio, uint8_t stages, uint32_t outCnt)
+{
+	double sum = 0.0, err, centre;
+	uint32_t k;
+
+	for(k = stages; k < outCnt; k++)
+	{
+		centre = (double)ratio * (k + 1U) - 1.0 - stages * (ratio - 1.0) / 2.0;
+		err = (double)out[k] / (1U << (TEST_OUT_BITS - TEST_IN_BITS)) - test_Ramp(centre);
+		sum += err * err;
+	}
+	return sqrt(sum / (outCnt - stages));
+}
+
+static double test_Run(uint32_t ratio, uint8_t stages)
+{
+	decimator_t dec;
+	uint32_t outCnt, refCnt, splitCnt = 0, done = 0, n;
+
+	assert(dec_Init(&dec, ratio, stages, TEST_IN_BITS, TEST_OUT_BITS) == status_DEC_Success);
+	outCnt = dec_Process(&dec, block + 1, TEST_CHANNELS, TEST_SAMPLES, out);
+	refCnt = test_Reference(ratio, stages, dec.outShift);
+	assert(outCnt == TEST_SAMPLES / ratio);
+	assert(outCnt == refCnt);
+	if(memcmp(out, ref, outCnt * sizeof(out[0])) != 0)
+	{
+		printf("order %u, ratio %u differs from the reference CIC\n", stages, ratio);
+		exit(1);
+	}
+
+	/* Blocks of any size, ending anywhere inside an output */
+	dec_Reset(&dec);
+	while(done < TEST_SAMPLES)
+	{
+		n = 1U + test_Rand() % (3U * ratio);
+		if(n > TEST_SAMPLES - done)
+		{
+			n = TEST_SAMPLES - done;
+		}
+		splitCnt += dec_Process(&dec, block + 1 + done * TEST_CHANNELS, TEST_CHANNELS, n, split + splitCnt);
+		done += n;
+	}
+	assert(splitCnt == outCnt);
+	assert(memcmp(out, split, outCnt * sizeof(out[0])) == 0);
+	return test_Rms(ratio, stages, outCnt);
+}
+
+static void test_Init(void)
+{
+	decimator_t dec;
+
+	assert(dec_Init(&dec, 12, 1, 12, 16) == status_DEC_InvalidArgument);
+	assert(dec_Init(&dec, 1, 1, 12, 12) == status_DEC_InvalidArgument);
+	assert(dec_Init(&dec, 16, 0, 12, 16) == status_DEC_InvalidArgument);
+	assert(dec_Init(&dec, 16, DEC_MAX_STAGES + 1U, 12, 16) == status_DEC_InvalidArgument);
+	/* 12 bits plus 3 x 8 bits of growth does not fit 32 */
+	assert(dec_Init(&dec, 256, 3, 12, 16) == status_DEC_InvalidArgument);
+	/* More output bits than the filter grows */
+	assert(dec_Init(&dec, 4, 1, 12, 15) == status_DEC_InvalidArgument);
+	assert(dec_Init(NULL, 16, 1, 12, 16) == status_DEC_InvalidArgument);
+	assert(dec_Init(&dec, 64, 3, 12, 16) == status_DEC_Success);
+	assert(dec_Process(&dec, block, 0, 16, out) == 0);
+}
+
+int main(void)
+{
+	uint32_t ratio, maxRatio;
+	uint8_t stages;
+	double rms, prev;
+
+	host_Reset();
+	test_Init();
+	test_Signal();
+	printf("RMS error to the clean ramp, LSB%u (noise +-%d LSB)\n", TEST_IN_BITS, TEST_NOISE);
+	for(stages = 1; stages <= DEC_MAX_STAGES; stages++)
+	{
+		printf("  order %u:", stages);
+		prev = 0.0;
+		/* 4 extra output bits carry the gain of up to 4^4 oversampling */
+		maxRatio = 1U << ((DEC_MAX_BITS - TEST_IN_BITS) / stages);
+		if(maxRatio > 256U)
+		{
+			maxRatio = 256U;
+		}
+		for(ratio = 16U; ratio <= maxRatio; ratio <<= 2)
+		{
+			rms = test_Run(ratio, stages);
+			printf("  R=%u %.3f", ratio, rms);
+			/* 4x the samples should about halve the noise */
+			assert((prev == 0.0) || (rms < 0.65 * prev));
+			prev = rms;
+		}
+		printf("\n");
+	}
+	printf("test_decimator passed\n");
+	return 0;
+}
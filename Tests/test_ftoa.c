@@ -0,0 +1,152 @@
+/***************************************************************************
+ *
+ *	Filename: 		test_ftoa.c
+ *  Description:  	host test of my_ftoa_n and my_q16toa against the exact
+ *                  decimal expansion of the value, rounded half away from
+ *                  zero
+ *
+ *****************************************************************************/
+
+#include "includes.h"
+#include <math.h>
+
+#define TEST_RANDOM_CNT		(200000U)
+
+static uint8_t str[64];
+static uint32_t seed = 12345U;
+
+static uint32_t test_Rand(void)
+{
+	seed = seed * 1664525U + 1013904223U;
+	return seed;
+}
+
+/* glibc prints the exact binary value, round that string by hand */
+static void test_Reference(char *out, size_t size, double value, uint8_t decimals)
+{
+	char exact[256];
+	char *dot, *p;
+	int len;
+
+	len = snprintf(exact, sizeof(exact), "%.160f", value);
+	assert((len > 0) && ((size_t)len < sizeof(exact)));
+	dot = strchr(exact, '.');
+	p = dot + decimals + 1;
+	if(*p >= '5')
+	{
+		/* Carry back through the kept digits */
+		for(p = (decimals != 0U) ? dot + decimals : dot - 1; ; p--)
+		{
+			if(*p == '.')
+			{
+				continue;
+			}
+			if((*p == '-') || (p < exact))
+			{
+				memmove(p + 2, p + 1, strlen(p + 1) + 1U);
+				p[1] = '1';
+				dot++;
+				break;
+			}
+			if(*p != '9')
+			{
+				(*p)++;
+				break;
+			}
+			*p = '0';
+			if(p == exact)
+			{
+				memmove(exact + 1, exact, strlen(exact) + 1U);
+				exact[0] = '1';
+				dot++;
+				break;
+			}
+		}
+	}
+	dot[(decimals != 0U) ? decimals + 1U : 0U] = '\0';
+	/* No sign on a bare zero */
+	snprintf(out, size, "%s", (strcmp(exact, "-0") == 0) ? "0" : exact);
+}
+
+static void test_Float(float value, uint8_t decimals)
+{
+	char expect[256];
+
+	my_ftoa_n(str, value, decimals);
+	test_Reference(expect, sizeof(expect), value, decimals);
+	if(strcmp((char *)str, expect) != 0)
+	{
+		printf("my_ftoa_n(%.9g, %u) = \"%s\", expected \"%s\"\n", value, decimals, str, expect);
+		exit(1);
+	}
+}
+
+static void test_Q16(int32_t q16, uint8_t decimals)
+{
+	char expect[256];
+
+	my_q16toa(str, q16, decimals);
+	test_Reference(expect, sizeof(expect), q16 / 65536.0, decimals);
+	if(strcmp((char *)str, expect) != 0)
+	{
+		printf("my_q16toa(%d, %u) = \"%s\", expected \"%s\"\n", q16, decimals, str, expect);
+		exit(1);
+	}
+}
+
+static void test_Fixed(void)
+{
+	/* Truncating the fraction to 32 bits before rounding printed 0.000 */
+	assert(strcmp((char *)my_ftoa(str, 0.0005f), "0.001") == 0);
+	assert(strcmp((char *)my_ftoa(str, -0.0005f), "-0.001") == 0);
+	assert(strcmp((char *)my_ftoa(str, 0.0004f), "0.000") == 0);
+	assert(strcmp((char *)my_ftoa(str, 1.9995f), "2.000") == 0);
+	assert(strcmp((char *)my_ftoa(str, 25.5f), "25.500") == 0);
+	assert(strcmp((char *)my_ftoa_n(str, 0.25f, 1), "0.3") == 0);
+	assert(strcmp((char *)my_ftoa_n(str, 2.5f, 0), "3") == 0);
+	assert(strcmp((char *)my_ftoa_n(str, -0.4f, 0), "0") == 0);
+	assert(strcmp((char *)my_ftoa_n(str, 0.0000000015f, 9), "0.000000002") == 0);
+	assert(strcmp((char *)my_ftoa_n(str, 4294967040.0f, 2), "4294967040.00") == 0);
+	assert(strcmp((char *)my_ftoa(str, 4294967296.0f), "ovf") == 0);
+	assert(strcmp((char *)my_ftoa(str, -INFINITY), "-inf") == 0);
+	assert(strcmp((char *)my_ftoa(str, NAN), "nan") == 0);
+	assert(strcmp((char *)my_q16toa(str, -98304, 3), "-1.500") == 0);
+	assert(my_ftoa(NULL, 1.0f) == NULL);
+}
+
+static void test_Random(void)
+{
+	uint32_t i, bits;
+	uint8_t decimals;
+	float value;
+
+	for(i = 0; i < TEST_RANDOM_CNT; i++)
+	{
+		/* Any sign and mantissa, exponents from subnormal up to 2^31 */
+		bits = test_Rand();
+		bits = (bits & 0x807FFFFFU) | ((test_Rand() % 159U) << 23);
+		memcpy(&value, &bits, sizeof(value));
+		decimals = (uint8_t)(i % (DATA_FTOA_MAX_DECIMALS + 1U));
+		test_Float(value, decimals);
+		test_Q16((int32_t)test_Rand(), decimals);
+	}
+	/* Values just around the rounding points of three decimals */
+	for(i = 0; i < 100000U; i++)
+	{
+		value = (float)((i >> 1) + 0.5) / 1000.0f;
+		bits = 0;
+		memcpy(&bits, &value, sizeof(bits));
+		bits += (i & 1U) ? 1U : -1U;
+		memcpy(&value, &bits, sizeof(value));
+		test_Float(value, 3);
+	}
+}
+
+int main(void)
+{
+	host_Reset();
+	test_Fixed();
+	test_Random();
+	printf("test_ftoa passed\n");
+	return 0;
+}
@@ -0,0 +1,55 @@
+/***************************************************************************
+ *
+ *	Filename: 		test_log.c
+ *  Description:  	host test of the log stream: events, deferred text
+ *                  and memory dumps interleaved on the UART0 wire. The
+ *                  capture is written to the file named on the command
+ *                  line for test_log_decode.py to decode.
+ *
+ *****************************************************************************/
+
+#include "includes.h"
+
+#define TEST_LONG_LEN		(300U)
+
+extern CircBuf_t * tx_buf;
+
+static uint8_t longText[TEST_LONG_LEN + 1];
+
+int main(int argc, char **argv)
+{
+	static uint8_t mem[] = {0x3F, 0x00, 0x85, 0x01, 0x7F, 0xFF};
+	int32_t args[3] = {-1, 300, 70000};
+	const uint8_t *wire;
+	uint32_t wireLength;
+	FILE *f;
+
+	assert(argc == 2);
+	host_Reset();
+	uart0_Init(9600, 0, 0, 8, 1);
+	memset(longText, 'x', TEST_LONG_LEN);
+
+	log_Event(SYSTEM_INITIALIZED);
+	log_Int((uint8_t *)"adc temp25 ", 1234);
+	log_Str((uint8_t *)"plain text\r\n");
+	log_Event1(READING_SYS_TEMPERATURE, -250);
+	log_Q16((uint8_t *)"q16 ", (3 << 16) / 2);
+	/* Deferred: the event above goes out before the text queued ahead of it */
+	assert(!log_Process());
+	/* A payload that looks like records must not be taken for them */
+	log_Mem(mem, sizeof(mem));
+	log_EventArgs(SYSTEM_SENSED_TOUCH, args, 3);
+	log_Str(longText);
+	assert(!log_Process());
+	log_Event(SYSTEM_NORMAL);
+
+	host_Service();
+	assert(cb_IsEmpty(tx_buf) == EMPTY);
+	wireLength = host_UartWire(&wire);
+	f = fopen(argv[1], "wb");
+	assert(f);
+	assert(fwrite(wire, 1, wireLength, f) == wireLength);
+	fclose(f);
+	printf("test_log wrote %u bytes\n", wireLength);
+	return 0;
+}
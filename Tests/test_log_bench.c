@@ -0,0 +1,100 @@
+/***************************************************************************
+ *
+ *	Filename: 		test_log_bench.c
+ *  Description:  	host benchmark of the per-call cost of a deferred
+ *                  log_Int against formatting it on the spot, and the
+ *                  frame sizes behind LOG_RECORD_CNT. log.c is included
+ *                  to reach its static record and frame writers.
+ *
+ *****************************************************************************/
+
+#include "../Src/log.c"
+
+#define BENCH_CALLS			(LOG_RECORD_CNT)		// Calls per batch, one full ring
+#define BENCH_BATCHES		(200000U)
+
+/* What log_Int used to do: format and enqueue at the call site */
+static void bench_EagerInt(uint8_t * str, int32_t data)
+{
+	uint8_t temp[32];
+
+	my_itoa(temp, data, 10);
+	log_PutFrame(LOG_EVT_TEXT, str, strlen((const char *)str), temp, strlen((const char *)temp));
+}
+
+/* Record sizes of the log_Int call sites in the tree, with typical values */
+static void bench_FrameSizes(void)
+{
+	static const struct
+	{
+		const char *str;
+		int32_t value;
+	}site[] =
+	{
+		{"adc temp25 from flash ",	47612},
+		{"adc bandgap ",			17920},
+		{"adc temp25 ",				47612},
+		{"tsi baseline ",			1483},
+		{"tsi touch delta ",		62},
+	};
+	uint32_t i, before, total = 0;
+
+	for(i = 0; i < sizeof(site) / sizeof(site[0]); i++)
+	{
+		cb_Empty_Buff(tx_buf);
+		before = cb_Length(tx_buf);
+		bench_EagerInt((uint8_t *)site[i].str, site[i].value);
+		total += cb_Length(tx_buf) - before;
+	}
+	cb_Empty_Buff(tx_buf);
+	printf("  mean frame of the log_Int sites: %.1f bytes, %.1f frames fill the %u-byte TX buffer\n",
+		   (double)total / i, (double)UART0_TX_BUF_SIZE * i / total, UART0_TX_BUF_SIZE);
+	printf("  record ring: %u records x %u bytes (host pointers) = %u bytes of RAM\n",
+		   LOG_RECORD_CNT, (unsigned)sizeof(log_record_t), LOG_RECORD_CNT * (unsigned)sizeof(log_record_t));
+}
+
+int main(void)
+{
+	uint64_t start, deferredNs = 0, eagerNs = 0;
+	uint32_t batch, i;
+
+	host_Reset();
+	uart0_Init(9600, 0, 0, 8, 1);
+	/* Keep the transmitter off so only the logging calls are timed */
+	uart0_TranCtl(UART_TX_DISABLE, UART_RX_DISABLE);
+
+	for(batch = 0; batch < BENCH_BATCHES; batch++)
+	{
+		start = host_NowNs();
+		for(i = 0; i < BENCH_CALLS; i++)
+		{
+			log_Int((uint8_t *)"tsi baseline ", (int32_t)(batch + i));
+		}
+		deferredNs += host_NowNs() - start;
+		assert(logDropped == 0);
+		logHead = logTail;
+
+		start = host_NowNs();
+		for(i = 0; i < BENCH_CALLS; i++)
+		{
+			bench_EagerInt((uint8_t *)"tsi baseline ", (int32_t)(batch + i));
+		}
+		eagerNs += host_NowNs() - start;
+		cb_Empty_Buff(tx_buf);
+	}
+
+	printf("log_Int per call over %u calls:\n", BENCH_CALLS * BENCH_BATCHES);
+	printf("  deferred   %6.1f ns\n", (double)deferredNs / (BENCH_CALLS * BENCH_BATCHES));
+	printf("  eager      %6.1f ns  (%.1fx)\n", (double)eagerNs / (BENCH_CALLS * BENCH_BATCHES),
+		   (double)eagerNs / deferredNs);
+	bench_FrameSizes();
+
+	/* A full ring drops the next record instead of blocking */
+	for(i = 0; i <= LOG_RECORD_CNT; i++)
+	{
+		log_Int((uint8_t *)"x ", 1);
+	}
+	assert(logDropped == 1);
+	printf("test_log_bench passed\n");
+	return 0;
+}
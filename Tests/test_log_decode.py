@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+#
+#	Filename: 		test_log_decode.py
+#   Description:  	decode the capture written by test_log and check that
+#                   every record comes back, text and memory frames included
+#   Usage:          test_log_decode.py <repo>/Tools capture.bin
+
+import sys
+
+sys.path.insert(0, sys.argv[1])
+import log_decode  # noqa: E402
+
+EXPECTED = [
+    "SYSTEM_INITIALIZED",
+    "READING_SYS_TEMPERATURE -250",
+    "adc temp25 1234",
+    "plain text",
+    "q16 1.500",
+    "MEM 3f 00 85 01 7f ff",
+    "SYSTEM_SENSED_TOUCH -1 300 70000",
+    "x" * 127,
+    "SYSTEM_NORMAL",
+]
+
+
+def main():
+    with open(sys.argv[2], "rb") as f:
+        data = f.read()
+    lines = log_decode.decode(data)
+    # Drop the timestamp columns
+    messages = [line.split(" ms  ", 1)[1] for line in lines]
+    if messages != EXPECTED:
+        print("decoded:")
+        for line in lines:
+            print("  " + line)
+        sys.exit(1)
+    # Time only moves forward, the frames share the events' delta chain
+    times = [float(line.split()[0]) for line in lines]
+    assert times == sorted(times)
+    print("test_log_decode passed, %d records" % len(lines))
+
+
+if __name__ == "__main__":
+    main()
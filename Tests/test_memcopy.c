@@ -0,0 +1,140 @@
+/***************************************************************************
+ *
+ *	Filename: 		test_memcopy.c
+ *  Description:  	host test of mem_Copy: which path (CPU or DMA) each
+ *                  copy takes, that both produce memmove's result, and
+ *                  that calibration leaves SysTick as it found it
+ *
+ *****************************************************************************/
+
+#include "includes.h"
+
+#define TEST_BUF_SIZE		(2048U)
+
+static uint8_t buf[TEST_BUF_SIZE];
+static uint8_t ref[TEST_BUF_SIZE];
+static uint32_t dmaCopies;
+
+dma_status_t __real_dma_MemcpyAsync(dma_job_t *job, uint8_t * dst, const uint8_t * src,
+									uint32_t length, dma_job_callback_t callback, void *usrData);
+
+/* Linked with --wrap to see which copies mem_Copy hands to the DMA */
+dma_status_t __wrap_dma_MemcpyAsync(dma_job_t *job, uint8_t * dst, const uint8_t * src,
+									uint32_t length, dma_job_callback_t callback, void *usrData)
+{
+	dma_status_t status = __real_dma_MemcpyAsync(job, dst, src, length, callback, usrData);
+
+	if(status == status_DMA_Success)
+	{
+		dmaCopies++;
+	}
+	return status;
+}
+
+static void test_Fill(void)
+{
+	uint32_t i;
+
+	for(i = 0; i < TEST_BUF_SIZE; i++)
+	{
+		buf[i] = (uint8_t)(i * 13U + 7U);
+	}
+	memcpy(ref, buf, TEST_BUF_SIZE);
+}
+
+/* Copy within buf and return whether the DMA was used */
+static bool test_Copy(uint32_t dstOff, uint32_t srcOff, uint32_t length)
+{
+	uint32_t before = dmaCopies;
+
+	test_Fill();
+	memmove(ref + dstOff, ref + srcOff, length);
+	assert(mem_Copy(buf + dstOff, buf + srcOff, length) == 0);
+	if(memcmp(buf, ref, TEST_BUF_SIZE) != 0)
+	{
+		printf("mem_Copy(dst +%u, src +%u, %u) differs from memmove\n", dstOff, srcOff, length);
+		exit(1);
+	}
+	return dmaCopies != before;
+}
+
+static void test_Dispatch(void)
+{
+	uint32_t threshold = 256U;
+
+	mem_SetDmaThreshold(threshold);
+	assert(mem_GetDmaThreshold() == threshold);
+
+	/* Long, aligned, no backward overlap: DMA */
+	assert(test_Copy(1024, 0, threshold));
+	assert(test_Copy(0, 1024, 1000));
+	/* The DMA takes the words, the CPU the odd tail */
+	assert(test_Copy(1024, 0, threshold + 3U));
+	/* A forward overlap is safe for the DMA */
+	assert(test_Copy(0, 64, 512));
+	/* Short, unaligned, or overlapping backward: CPU */
+	assert(!test_Copy(1024, 0, threshold - 4U));
+	assert(!test_Copy(1025, 0, 512));
+	assert(!test_Copy(1024, 2, 512));
+	assert(!test_Copy(64, 0, 512));
+	assert(mem_Copy(NULL, buf, 16) != 0);
+
+	/* Every channel taken: the CPU does the copy */
+	while(dma_ChannelAlloc() != DMA_CHANNEL_NONE)
+	{}
+	assert(!test_Copy(1024, 0, 512));
+	assert(dmaCopies != 0);
+	{
+		uint8_t ch;
+		for(ch = 0; ch < DMA_CHANNEL_CNT; ch++)
+		{
+			dma_ChannelFree(ch);
+		}
+	}
+}
+
+/* Every length and alignment around the threshold, on both paths */
+static void test_Sweep(void)
+{
+	uint32_t length, dstOff, srcOff;
+
+	mem_SetDmaThreshold(64U);
+	for(length = 1; length <= 200U; length += 7U)
+	{
+		for(dstOff = 512; dstOff < 520U; dstOff++)
+		{
+			for(srcOff = 0; srcOff < 8U; srcOff++)
+			{
+				test_Copy(dstOff, srcOff, length);
+				test_Copy(srcOff, dstOff, length);
+			}
+		}
+	}
+}
+
+static void test_Calibrate(void)
+{
+	uint32_t threshold;
+
+	/* Whatever SysTick was doing must survive the calibration */
+	SysTick->LOAD = 1234U;
+	SysTick->CTRL = SysTick_CTRL_TICKINT_Msk;
+	threshold = mem_CalibrateDmaThreshold();
+	assert(SysTick->LOAD == 1234U);
+	assert(SysTick->CTRL == SysTick_CTRL_TICKINT_Msk);
+	assert(threshold == mem_GetDmaThreshold());
+	assert((threshold == MEM_CALIBRATION_MAX_LENGTH + 1U) ||
+		   ((threshold >= 16U) && (threshold <= MEM_CALIBRATION_MAX_LENGTH) &&
+			((threshold & (threshold - 1U)) == 0U)));
+	printf("calibrated DMA threshold on the host model: %u\n", threshold);
+}
+
+int main(void)
+{
+	host_Reset();
+	test_Dispatch();
+	test_Sweep();
+	test_Calibrate();
+	printf("test_memcopy passed\n");
+	return 0;
+}
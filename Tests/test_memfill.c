@@ -0,0 +1,121 @@
+/***************************************************************************
+ *
+ *	Filename: 		test_memfill.c
+ *  Description:  	host test of mem_Fill and my_memzero over lengths and
+ *                  alignments, and a benchmark against a byte-wise fill
+ *                  and memset
+ *
+ *****************************************************************************/
+
+#include "includes.h"
+
+#define TEST_MAX_LENGTH		(300U)
+#define TEST_GUARD			(8U)
+#define BENCH_SIZE			(1024U)		// A sensor or queue buffer
+#define BENCH_BYTES			(256U * 1024U * 1024U)
+
+static uint8_t buf[TEST_MAX_LENGTH + 2U * TEST_GUARD];
+static uint8_t benchBuf[BENCH_SIZE + 8U];
+
+static void test_Check(uint32_t offset, uint32_t pattern, uint32_t length, bool zero)
+{
+	uint32_t i;
+	uint8_t expect;
+
+	memset(buf, 0xA5, sizeof(buf));
+	if(zero)
+	{
+		assert(my_memzero(buf + TEST_GUARD + offset, length) == 0);
+	}
+	else
+	{
+		assert(mem_Fill(buf + TEST_GUARD + offset, pattern, length) == 0);
+	}
+	for(i = 0; i < sizeof(buf); i++)
+	{
+		if((i < TEST_GUARD + offset) || (i >= TEST_GUARD + offset + length))
+		{
+			expect = 0xA5;		// Outside the fill: untouched
+		}
+		else
+		{
+			expect = zero ? 0U : (uint8_t)(pattern >> (((i - TEST_GUARD - offset) & 3U) * 8U));
+		}
+		if(buf[i] != expect)
+		{
+			printf("fill +%u, %u bytes of 0x%08X: byte %u is 0x%02X, expected 0x%02X\n",
+				   offset, length, pattern, i, buf[i], expect);
+			exit(1);
+		}
+	}
+}
+
+static void test_Fill(void)
+{
+	static const uint32_t patterns[] = {0x00000000U, 0xFFFFFFFFU, 0x11223344U, 0x80C0E0F0U};
+	uint32_t length, offset, p;
+
+	for(length = 0; length <= TEST_MAX_LENGTH; length++)
+	{
+		for(offset = 0; offset < TEST_GUARD; offset++)
+		{
+			for(p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++)
+			{
+				test_Check(offset, patterns[p], length, false);
+			}
+			test_Check(offset, 0, length, true);
+		}
+	}
+	assert(mem_Fill(NULL, 0, 4) != 0);
+}
+
+/* The byte loop my_memzero used to be */
+static void bench_ByteZero(uint8_t *dst, uint32_t length)
+{
+	volatile uint8_t *p = dst;
+
+	while(length--)
+	{
+		*p++ = 0;
+	}
+}
+
+static void bench_FillZero(uint8_t *dst, uint32_t length)
+{
+	mem_Fill(dst, 0U, length);
+}
+
+static void bench_Memset(uint8_t *dst, uint32_t length)
+{
+	memset(dst, 0, length);
+}
+
+static double bench_Run(void (*fill)(uint8_t *, uint32_t), uint32_t offset)
+{
+	uint64_t start = host_NowNs();
+	uint32_t done;
+
+	for(done = 0; done < BENCH_BYTES; done += BENCH_SIZE)
+	{
+		fill(benchBuf + offset, BENCH_SIZE);
+		__asm__ volatile("" ::: "memory");
+	}
+	return BENCH_BYTES / (double)(host_NowNs() - start) * 1000.0;
+}
+
+int main(void)
+{
+	uint32_t offset;
+
+	host_Reset();
+	test_Fill();
+	printf("%u-byte zero fills, MB/s   byte loop  mem_Fill  memset\n", BENCH_SIZE);
+	for(offset = 0; offset < 4U; offset += 3U)
+	{
+		printf("  dst +%u                  %9.0f  %8.0f  %6.0f\n", offset,
+			   bench_Run(bench_ByteZero, offset), bench_Run(bench_FillZero, offset),
+			   bench_Run(bench_Memset, offset));
+	}
+	printf("test_memfill passed\n");
+	return 0;
+}
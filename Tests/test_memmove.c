@@ -0,0 +1,119 @@
+/***************************************************************************
+ *
+ *	Filename: 		test_memmove.c
+ *  Description:  	host test of my_memmove_word against memmove over
+ *                  every overlap and alignment, and a benchmark of the
+ *                  byte, word and library copies
+ *
+ *****************************************************************************/
+
+#include "includes.h"
+
+#define TEST_SPAN			(96U)		// Lengths and offsets swept exhaustively
+#define TEST_BUF_SIZE		(2U * TEST_SPAN + 16U)
+#define BENCH_SIZE			(4096U)
+#define BENCH_BYTES			(256U * 1024U * 1024U)
+
+/* Static, so the uint32_t pointer masking in memory.c holds on the host */
+static uint8_t buf[TEST_BUF_SIZE];
+static uint8_t ref[TEST_BUF_SIZE];
+static uint8_t benchSrc[BENCH_SIZE + 8U];
+static uint8_t benchDst[BENCH_SIZE + 8U];
+
+static void test_Fill(uint8_t *p, uint32_t size)
+{
+	uint32_t i;
+
+	for(i = 0; i < size; i++)
+	{
+		p[i] = (uint8_t)(i * 29U + 3U);
+	}
+}
+
+/* Every source and destination offset in one buffer covers forward and
+ * backward overlaps at all distances, plus disjoint copies, for all
+ * four source/destination alignments */
+static void test_Exhaustive(void)
+{
+	uint32_t length, srcOff, dstOff;
+	uint32_t cases = 0;
+
+	for(length = 1; length <= TEST_SPAN; length++)
+	{
+		for(srcOff = 0; srcOff + length <= TEST_BUF_SIZE; srcOff += (srcOff < 8U) ? 1U : 5U)
+		{
+			for(dstOff = 0; dstOff + length <= TEST_BUF_SIZE; dstOff++)
+			{
+				test_Fill(buf, TEST_BUF_SIZE);
+				test_Fill(ref, TEST_BUF_SIZE);
+				memmove(ref + dstOff, ref + srcOff, length);
+				assert(my_memmove_word(buf + srcOff, buf + dstOff, (int32_t)length) == 0);
+				if(memcmp(buf, ref, TEST_BUF_SIZE) != 0)
+				{
+					printf("my_memmove_word(src +%u, dst +%u, %u) differs from memmove\n",
+						   srcOff, dstOff, length);
+					exit(1);
+				}
+				cases++;
+			}
+		}
+	}
+	assert(my_memmove_word(buf, buf + 1, 0) != 0);
+	assert(my_memmove_word(NULL, buf, 4) != 0);
+	printf("my_memmove_word matches memmove in %u cases\n", cases);
+}
+
+typedef void (*bench_copy_t)(uint8_t *src, uint8_t *dst, uint32_t length);
+
+static void bench_Byte(uint8_t *src, uint8_t *dst, uint32_t length)
+{
+	my_memmove(src, dst, (int32_t)length);
+}
+
+static void bench_Word(uint8_t *src, uint8_t *dst, uint32_t length)
+{
+	my_memmove_word(src, dst, (int32_t)length);
+}
+
+static void bench_Libc(uint8_t *src, uint8_t *dst, uint32_t length)
+{
+	memmove(dst, src, length);
+}
+
+static double bench_Run(bench_copy_t copy, uint32_t srcOff, uint32_t dstOff)
+{
+	uint64_t start = host_NowNs();
+	uint32_t done;
+
+	for(done = 0; done < BENCH_BYTES; done += BENCH_SIZE)
+	{
+		copy(benchSrc + srcOff, benchDst + dstOff, BENCH_SIZE);
+	}
+	assert(memcmp(benchSrc + srcOff, benchDst + dstOff, BENCH_SIZE) == 0);
+	return BENCH_BYTES / (double)(host_NowNs() - start) * 1000.0;
+}
+
+static void bench_Copies(void)
+{
+	static const uint32_t offsets[][2] = {{0, 0}, {1, 1}, {1, 2}, {3, 0}};
+	uint32_t i;
+
+	test_Fill(benchSrc, sizeof(benchSrc));
+	printf("%u-byte copies, MB/s     my_memmove  my_memmove_word  memmove\n", BENCH_SIZE);
+	for(i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++)
+	{
+		printf("  src +%u, dst +%u        %10.0f  %15.0f  %7.0f\n", offsets[i][0], offsets[i][1],
+			   bench_Run(bench_Byte, offsets[i][0], offsets[i][1]),
+			   bench_Run(bench_Word, offsets[i][0], offsets[i][1]),
+			   bench_Run(bench_Libc, offsets[i][0], offsets[i][1]));
+	}
+}
+
+int main(void)
+{
+	host_Reset();
+	test_Exhaustive();
+	bench_Copies();
+	printf("test_memmove passed\n");
+	return 0;
+}
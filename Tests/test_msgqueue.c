@@ -0,0 +1,102 @@
+/***************************************************************************
+ *
+ *	Filename: 		test_msgqueue.c
+ *  Description:  	host stress test of the SPSC message queue, with the
+ *                  producer (standing in for the ISRs) and the consumer
+ *                  (the main loop) on two threads
+ *
+ *****************************************************************************/
+
+#include "includes.h"
+#include <pthread.h>
+#include <sched.h>
+
+#define STRESS_MSG_CNT		(1000000U)
+
+static msg_queue_t queue;
+static msg_queue_handler_t handler;
+
+/* Messages count 1..255 so a lost, repeated or torn one breaks the sequence */
+static uint8_t test_MsgOf(uint32_t i)
+{
+	return (uint8_t)(i % 255U + 1U);
+}
+
+static void * test_Producer(void *arg)
+{
+	uint32_t i;
+	uint8_t msg;
+
+	(void)arg;
+	for(i = 0; i < STRESS_MSG_CNT; i++)
+	{
+		msg = test_MsgOf(i);
+		while(SYS_MsgEnqueue(handler, &msg) != status_SYS_Success)
+		{
+			sched_yield();		// Let a single-core host run the consumer
+		}
+	}
+	return NULL;
+}
+
+static void * test_Consumer(void *arg)
+{
+	uint32_t i;
+	uint8_t msg;
+
+	(void)arg;
+	for(i = 0; i < STRESS_MSG_CNT; i++)
+	{
+		while(SYS_MsgDequeue(handler, &msg) != status_SYS_Success)
+		{
+			sched_yield();
+		}
+		if(msg != test_MsgOf(i))
+		{
+			printf("message %u: got %u, expected %u\n", i, msg, test_MsgOf(i));
+			exit(1);
+		}
+	}
+	return NULL;
+}
+
+static void test_Capacity(void)
+{
+	uint8_t msg = 7, out;
+	uint32_t i;
+
+	handler = SYS_MsgQueueCreate(&queue, ST_MSG_QUEUE_SIZE);
+	assert(SYS_MsgQueueIsEmpty(handler));
+	assert(SYS_MsgDequeue(handler, &out) == status_SYS_Error);
+	for(i = 0; i < ST_MSG_QUEUE_SIZE; i++)
+	{
+		assert(SYS_MsgEnqueue(handler, &msg) == status_SYS_Success);
+	}
+	assert(SYS_MsgEnqueue(handler, &msg) == status_SYS_Error);
+	for(i = 0; i < ST_MSG_QUEUE_SIZE; i++)
+	{
+		assert(SYS_MsgDequeue(handler, &out) == status_SYS_Success);
+		assert(out == msg);
+	}
+	assert(SYS_MsgQueueIsEmpty(handler));
+	free(queue.queueMem);
+}
+
+int main(void)
+{
+	pthread_t producer, consumer;
+
+	host_Reset();
+	test_Capacity();
+
+	handler = SYS_MsgQueueCreate(&queue, ST_MSG_QUEUE_SIZE);
+	assert(pthread_create(&consumer, NULL, test_Consumer, NULL) == 0);
+	assert(pthread_create(&producer, NULL, test_Producer, NULL) == 0);
+	pthread_join(producer, NULL);
+	pthread_join(consumer, NULL);
+	assert(SYS_MsgQueueIsEmpty(handler));
+	free(queue.queueMem);
+
+	printf("test_msgqueue passed, %u messages\n", STRESS_MSG_CNT);
+	return 0;
+}
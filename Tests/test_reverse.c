@@ -0,0 +1,153 @@
+/***************************************************************************
+ *
+ *	Filename: 		test_reverse.c
+ *  Description:  	host test of my_reverse against a byte-wise reverse
+ *                  over every length and alignment, of the array byte
+ *                  swaps, and a benchmark of the reverses
+ *
+ *****************************************************************************/
+
+#include "includes.h"
+
+#define TEST_MAX_LENGTH		(1024U)
+#define TEST_GUARD			(8U)
+#define TEST_SWAP_CNT		(64U)
+#define BENCH_SIZE			(1024U)
+#define BENCH_BYTES			(256U * 1024U * 1024U)
+
+static uint8_t buf[TEST_MAX_LENGTH + 2U * TEST_GUARD];
+static uint8_t ref[TEST_MAX_LENGTH + 2U * TEST_GUARD];
+static uint16_t half[TEST_SWAP_CNT + 2U];
+static uint32_t word[TEST_SWAP_CNT];
+static uint8_t benchBuf[BENCH_SIZE + 8U];
+
+static void test_Fill(uint8_t *p, uint32_t size)
+{
+	uint32_t i;
+
+	for(i = 0; i < size; i++)
+	{
+		p[i] = (uint8_t)(i * 37U + 11U);
+	}
+}
+
+/* The byte loop my_reverse used to be */
+static void test_ByteReverse(uint8_t *str, uint32_t length)
+{
+	uint8_t *left = str;
+	uint8_t *right = str + length;
+	uint8_t temp;
+
+	while(right - left > 1)
+	{
+		temp = *left;
+		*left++ = *--right;
+		*right = temp;
+	}
+}
+
+static void test_Reverse(void)
+{
+	uint32_t length, offset;
+
+	for(length = 0; length <= TEST_MAX_LENGTH; length++)
+	{
+		for(offset = 0; offset < TEST_GUARD; offset++)
+		{
+			test_Fill(buf, sizeof(buf));
+			test_Fill(ref, sizeof(ref));
+			test_ByteReverse(ref + TEST_GUARD + offset, length);
+			assert(my_reverse(buf + TEST_GUARD + offset, length) == 0);
+			if(memcmp(buf, ref, sizeof(buf)) != 0)
+			{
+				printf("my_reverse(+%u, %u) differs from the byte-wise reverse\n", offset, length);
+				exit(1);
+			}
+		}
+	}
+	assert(my_reverse(NULL, 4) != 0);
+}
+
+static void test_Bswap(void)
+{
+	uint32_t count, start, i;
+
+	/* Word aligned and halfword aligned starts, every count and tail */
+	for(start = 0; start < 2U; start++)
+	{
+		for(count = 0; count <= TEST_SWAP_CNT; count++)
+		{
+			for(i = 0; i < TEST_SWAP_CNT + 2U; i++)
+			{
+				half[i] = (uint16_t)(i * 0x0203U + 0x1001U);
+			}
+			assert(mem_Bswap16_Array(half + start, count) == 0);
+			for(i = 0; i < TEST_SWAP_CNT + 2U; i++)
+			{
+				uint16_t orig = (uint16_t)(i * 0x0203U + 0x1001U);
+				bool inside = (i >= start) && (i < start + count);
+
+				assert(half[i] == (inside ? (uint16_t)((orig >> 8) | (orig << 8)) : orig));
+			}
+		}
+	}
+	for(count = 0; count <= TEST_SWAP_CNT; count++)
+	{
+		for(i = 0; i < TEST_SWAP_CNT; i++)
+		{
+			word[i] = i * 0x01020304U + 0x10203040U;
+		}
+		assert(mem_Bswap32_Array(word, count) == 0);
+		for(i = 0; i < TEST_SWAP_CNT; i++)
+		{
+			uint32_t orig = i * 0x01020304U + 0x10203040U;
+
+			assert(word[i] == ((i < count) ? __builtin_bswap32(orig) : orig));
+		}
+	}
+	assert(mem_Bswap16_Array(NULL, 1) != 0);
+	assert(mem_Bswap32_Array(NULL, 1) != 0);
+}
+
+static void bench_Byte(uint8_t *str, uint32_t length)
+{
+	test_ByteReverse(str, length);
+}
+
+static void bench_Word(uint8_t *str, uint32_t length)
+{
+	my_reverse(str, length);
+}
+
+static double bench_Run(void (*reverse)(uint8_t *, uint32_t), uint32_t offset, uint32_t length)
+{
+	uint64_t start = host_NowNs();
+	uint32_t done;
+
+	for(done = 0; done < BENCH_BYTES; done += length)
+	{
+		reverse(benchBuf + offset, length);
+		__asm__ volatile("" ::: "memory");
+	}
+	return BENCH_BYTES / (double)(host_NowNs() - start) * 1000.0;
+}
+
+int main(void)
+{
+	static const uint32_t cases[][2] = {{0, BENCH_SIZE}, {1, BENCH_SIZE}, {0, BENCH_SIZE - 1U}, {3, 33}};
+	uint32_t i;
+
+	host_Reset();
+	test_Reverse();
+	test_Bswap();
+	test_Fill(benchBuf, sizeof(benchBuf));
+	printf("reverse, MB/s            byte loop  my_reverse\n");
+	for(i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+	{
+		printf("  +%u, %4u bytes         %9.0f  %10.0f\n", cases[i][0], cases[i][1],
+			   bench_Run(bench_Byte, cases[i][0], cases[i][1]),
+			   bench_Run(bench_Word, cases[i][0], cases[i][1]));
+	}
+	printf("test_reverse passed\n");
+	return 0;
+}
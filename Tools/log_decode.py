@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+#
+#	Filename: 		log_decode.py
+#   Description:  	decoder for the binary log stream written by log.c
+#   Usage:          log_decode.py capture.bin
+#                   log_decode.py < capture.bin
+#
+# Record layout (see log.h):
+#   byte 0     : bits 7..6 number of arguments, bits 5..0 event ID
+#   varint     : milliseconds since the previous record
+#   varint x n : zigzag encoded arguments
+#
+# Text (LOG_EVT_TEXT) and memory (LOG_EVT_MEM) frames have no arguments;
+# a varint payload length and the payload bytes follow the timestamp.
+
+import sys
+
+LOG_EVT_ID_MASK = 0x3F
+LOG_EVT_ARGC_SHIFT = 6
+LOG_EVT_MEM = 0x3E
+LOG_EVT_TEXT = 0x3F
+
+# Event IDs from task.h
+EVENT_NAMES = {
+    0x00: "SYSTEM_INITIALIZED",
+    0x01: "SYSTEM_ENTERED_WAIT",
+    0x02: "SYSTEM_NORMAL",
+    0x03: "SYSTEM_FAILED",
+    0x10: "READING_SYS_TEMPERATURE",
+    0x11: "SYSTEM_TEMPERATURE_NORMAL",
+    0x12: "SYSTEM_TEMPERATURE_OUTOFRANGE",
+    0x13: "TEMP_CALIBRATION_NOT_SAVED",
+    0x20: "SYSTEM_SENSED_TOUCH",
+    0x21: "TSI_BASELINE_FAILED",
+}
+
+
+def read_varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        if pos >= len(data):
+            raise EOFError
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value, pos
+        shift += 7
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def decode(data):
+    """Return the records of a captured stream as timestamped lines."""
+    lines = []
+    pos = 0
+    time_ms = 0
+    while pos < len(data):
+        header = data[pos]
+        evt = header & LOG_EVT_ID_MASK
+        payload = None
+        try:
+            delta, next_pos = read_varint(data, pos + 1)
+            args = []
+            for _ in range(header >> LOG_EVT_ARGC_SHIFT):
+                value, next_pos = read_varint(data, next_pos)
+                args.append(unzigzag(value))
+            if evt in (LOG_EVT_TEXT, LOG_EVT_MEM):
+                length, next_pos = read_varint(data, next_pos)
+                if next_pos + length > len(data):
+                    raise EOFError
+                payload = data[next_pos:next_pos + length]
+                next_pos += length
+        except EOFError:
+            sys.stderr.write("truncated record at offset %d\n" % pos)
+            break
+        pos = next_pos
+        time_ms += delta
+        line = "%10.3f s  +%5d ms  " % (time_ms / 1000.0, delta)
+        if evt == LOG_EVT_TEXT:
+            line += payload.decode("ascii", "replace").rstrip("\r\n")
+        elif evt == LOG_EVT_MEM:
+            line += "MEM " + payload.hex(" ")
+        else:
+            line += EVENT_NAMES.get(evt, "EVENT_0x%02X" % evt)
+            if args:
+                line += " " + " ".join(str(a) for a in args)
+        lines.append(line)
+    return lines
+
+
+def main():
+    if len(sys.argv) > 1:
+        with open(sys.argv[1], "rb") as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+    for line in decode(data):
+        print(line)
+
+
+if __name__ == "__main__":
+    main()